@@ -0,0 +1,544 @@
+/*****************************************************************
+Name    :csr_graph
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../Heap/key_index.h"
+#include "../Heap/heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The heaps, each one in its own namespace, see heap_benchmark.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "../Heap/binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main binomial_heap_main
+namespace binomial{
+#include "../Heap/binomial_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main leftist_heap_main
+namespace leftist{
+#include "../Heap/leftist_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main fibonacci_heap_main
+namespace fibonacci{
+#include "../Heap/fibonacci_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main pairing_heap_main
+namespace pairing{
+#include "../Heap/pairing_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main radix_heap_main
+namespace radix{
+#include "../Heap/radix_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+
+//Compressed sparse row, the out-edges of u are [offset[u], offset[u+1])
+//The binary edge list is a header of two uint32 n and m, followed by
+//m records of three uint32 u, v and weight.
+struct Edge{
+    uint32_t u;
+    uint32_t v;
+    uint32_t weight;
+};
+
+class CSRGraph{
+public:
+    int n=0;
+    int m=0;
+    vector<int> offset;
+    vector<int> target;
+    vector<int> weight;
+
+    CSRGraph();
+    CSRGraph(int n, const Edge *edges, int m, bool undirected);
+    void build(int n, const Edge *edges, int m, bool undirected);
+
+    //binary edge list
+    bool load(const char *path, bool undirected);
+    static bool save(const char *path, int n, const Edge *edges, int m);
+};
+
+CSRGraph::CSRGraph()
+{
+
+}
+
+CSRGraph::CSRGraph(int n, const Edge *edges, int m, bool undirected)
+{
+    build(n, edges, m, undirected);
+}
+
+//counting sort of the edges by source
+void CSRGraph::build(int n, const Edge *edges, int m, bool undirected)
+{
+    this->n = n;
+    this->m = undirected ? 2*m : m;
+    offset.assign(n+1, 0);
+    target.resize(this->m);
+    weight.resize(this->m);
+
+    for(int i=0; i<m; i++){
+        offset[edges[i].u + 1]++;
+        if(undirected){
+            offset[edges[i].v + 1]++;
+        }
+    }
+    for(int u=0; u<n; u++){
+        offset[u+1] += offset[u];
+    }
+
+    vector<int> next(offset.begin(), offset.end()-1);
+    for(int i=0; i<m; i++){
+        int e = next[edges[i].u]++;
+        target[e] = edges[i].v;
+        weight[e] = edges[i].weight;
+        if(undirected){
+            e = next[edges[i].v]++;
+            target[e] = edges[i].u;
+            weight[e] = edges[i].weight;
+        }
+    }
+}
+
+//map the file and build from the records in place
+bool CSRGraph::load(const char *path, bool undirected)
+{
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) < 0 || st.st_size < (off_t)(2*sizeof(uint32_t))){
+        close(fd);
+        return false;
+    }
+
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(MAP_FAILED == addr)
+        return false;
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+    const uint32_t *header = (const uint32_t *)addr;
+    uint32_t file_n = header[0];
+    uint32_t file_m = header[1];
+    const Edge *edges = (const Edge *)(header + 2);
+
+    //the size and every vertex must agree with the header
+    bool valid = (file_n <= INT_MAX && file_m <= INT_MAX/2 &&
+        (uint64_t)st.st_size == 2*sizeof(uint32_t) + (uint64_t)file_m*sizeof(Edge));
+    for(uint32_t i=0; valid && i<file_m; i++){
+        valid = (edges[i].u < file_n && edges[i].v < file_n);
+    }
+    if(valid){
+        build(file_n, edges, file_m, undirected);
+    }
+
+    munmap(addr, st.st_size);
+    return valid;
+}
+
+bool CSRGraph::save(const char *path, int n, const Edge *edges, int m)
+{
+    FILE *fp = fopen(path, "wb");
+    if(NULL == fp)
+        return false;
+
+    uint32_t header[2] = {(uint32_t)n, (uint32_t)m};
+    bool ok = (2 == fwrite(header, sizeof(uint32_t), 2, fp)) &&
+        ((size_t)m == fwrite(edges, sizeof(Edge), m, fp));
+    ok = (0 == fclose(fp)) && ok;
+
+    return ok;
+}
+
+//Priority queues of vertices for the engines
+//push, decrease and pop work on (vertex, key), every adapter maps the
+//vertex to the handle of its heap and back.
+
+//IndexedBinaryHeap, the handles are ints
+class IndexedQueue{
+    binary::IndexedBinaryHeap heap;
+    vector<int> handle_of;
+    vector<int> vertex_of;
+public:
+    void push(int vertex, int key);
+    void decrease(int vertex, int key);
+    int pop(int &key);
+    bool empty();
+};
+
+void IndexedQueue::push(int vertex, int key)
+{
+    int handle = heap.insert(key);
+    if(vertex >= (int)handle_of.size()){
+        handle_of.resize(vertex+1);
+    }
+    if(handle >= (int)vertex_of.size()){
+        vertex_of.resize(handle+1);
+    }
+    handle_of[vertex] = handle;
+    vertex_of[handle] = vertex;
+}
+
+void IndexedQueue::decrease(int vertex, int key)
+{
+    heap.decrease_key(handle_of[vertex], key);
+}
+
+int IndexedQueue::pop(int &key)
+{
+    int vertex = vertex_of[heap.min_handle()];
+    key = heap.extract_min();
+    return vertex;
+}
+
+bool IndexedQueue::empty()
+{
+    return 0 == heap.size();
+}
+
+//the node with the minimum of every node-based heap
+leftist::Node *minNodeOf(leftist::LeftistHeap &heap){ return heap.root; }
+binomial::Node *minNodeOf(binomial::BinomialHeap &heap){ return heap.minNode; }
+fibonacci::Node *minNodeOf(fibonacci::FibonacciHeap &heap){ return heap.minNode; }
+pairing::Node *minNodeOf(pairing::PairingHeap &heap){ return heap.root; }
+radix::Node *minNodeOf(radix::RadixHeap &heap){ return heap.find(heap.minimum()); }
+
+bool emptyOf(leftist::LeftistHeap &heap){ return NULL == heap.root; }
+bool emptyOf(binomial::BinomialHeap &heap){ return NULL == heap.minNode; }
+bool emptyOf(fibonacci::FibonacciHeap &heap){ return NULL == heap.minNode; }
+bool emptyOf(pairing::PairingHeap &heap){ return NULL == heap.root; }
+bool emptyOf(radix::RadixHeap &heap){ return 0 == heap.number; }
+
+//Heaps whose nodes keep their keys, the node is the handle
+template<class Heap>
+class NodeQueue{
+protected:
+    typedef decltype(declval<Heap&>().insert(0)) Handle;
+    Heap heap;
+    vector<Handle> handle_of;
+    unordered_map<Handle, int> vertex_of;
+public:
+    void push(int vertex, int key);
+    void decrease(int vertex, int key);
+    int pop(int &key);
+    bool empty();
+};
+
+template<class Heap>
+void NodeQueue<Heap>::push(int vertex, int key)
+{
+    Handle handle = heap.insert(key);
+    if(vertex >= (int)handle_of.size()){
+        handle_of.resize(vertex+1);
+    }
+    handle_of[vertex] = handle;
+    vertex_of[handle] = vertex;
+}
+
+template<class Heap>
+void NodeQueue<Heap>::decrease(int vertex, int key)
+{
+    heap.decrease_key(handle_of[vertex], key);
+}
+
+template<class Heap>
+int NodeQueue<Heap>::pop(int &key)
+{
+    Handle handle = minNodeOf(heap);
+    auto it = vertex_of.find(handle);
+    int vertex = it->second;
+    vertex_of.erase(it);
+
+    key = heap.extract_min();
+    return vertex;
+}
+
+template<class Heap>
+bool NodeQueue<Heap>::empty()
+{
+    return emptyOf(heap);
+}
+
+//Heaps that move the keys up by swapping with the parent, the vertices
+//on the path move down one node and the decreased one goes to the top
+template<class Heap>
+class SwapQueue : public NodeQueue<Heap>{
+    typedef typename NodeQueue<Heap>::Handle Handle;
+public:
+    void decrease(int vertex, int key);
+};
+
+template<class Heap>
+void SwapQueue<Heap>::decrease(int vertex, int key)
+{
+    Handle current = this->handle_of[vertex];
+    if(current->data <= key)
+        return;
+
+    //the same walk as decrease_key
+    Handle top = current;
+    while(top->parent && top->parent->data > key){
+        Handle parent = top->parent;
+        int moved = this->vertex_of[parent];
+        this->vertex_of[top] = moved;
+        this->handle_of[moved] = top;
+        top = parent;
+    }
+    this->vertex_of[top] = vertex;
+    this->handle_of[vertex] = top;
+
+    this->heap.decrease_key(current, key);
+}
+
+/*==============================================================*/
+//Function area
+//Dijkstra from the source, the distances must fit in an int.
+//Returns the sum of the distances of the reachable vertices.
+template<class Queue>
+long long dijkstra(CSRGraph &graph, int source, vector<int> &dist)
+{
+    Queue queue;
+    vector<char> done(graph.n, 0);
+    long long checksum = 0;
+
+    dist.assign(graph.n, INT_MAX);
+    dist[source] = 0;
+    queue.push(source, 0);
+    while(!queue.empty()){
+        int d;
+        int u = queue.pop(d);
+        done[u] = 1;
+        checksum += d;
+
+        for(int e=graph.offset[u]; e<graph.offset[u+1]; e++){
+            int v = graph.target[e];
+            int nd = d + graph.weight[e];
+            if(done[v] || nd >= dist[v])
+                continue;
+
+            if(INT_MAX == dist[v]){
+                queue.push(v, nd);
+            }else{
+                queue.decrease(v, nd);
+            }
+            dist[v] = nd;
+        }
+    }
+
+    return checksum;
+}
+
+//Prim on an undirected graph, a new tree is started from every vertex
+//not reached yet, so the result is the weight of the spanning forest.
+template<class Queue>
+long long prim(CSRGraph &graph)
+{
+    Queue queue;
+    vector<int> key(graph.n, INT_MAX);
+    vector<char> done(graph.n, 0);
+    long long total = 0;
+
+    for(int s=0; s<graph.n; s++){
+        if(done[s])
+            continue;
+
+        key[s] = 0;
+        queue.push(s, 0);
+        while(!queue.empty()){
+            int k;
+            int u = queue.pop(k);
+            done[u] = 1;
+            total += k;
+
+            for(int e=graph.offset[u]; e<graph.offset[u+1]; e++){
+                int v = graph.target[e];
+                int w = graph.weight[e];
+                if(done[v] || w >= key[v])
+                    continue;
+
+                if(INT_MAX == key[v]){
+                    queue.push(v, w);
+                }else{
+                    queue.decrease(v, w);
+                }
+                key[v] = w;
+            }
+        }
+    }
+
+    return total;
+}
+
+template<class Queue>
+void run_dijkstra(const char *name, CSRGraph &graph)
+{
+    vector<int> dist;
+    auto start = high_resolution_clock::now();
+    long long checksum = dijkstra<Queue>(graph, 0, dist);
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by Dijkstra with " << name << ": "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+}
+
+template<class Queue>
+void run_prim(const char *name, CSRGraph &graph)
+{
+    auto start = high_resolution_clock::now();
+    long long total = prim<Queue>(graph);
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by Prim with " << name << ": "
+         << duration.count() << " microseconds"
+         << ", weight :" << total << endl;
+}
+
+//n vertices with degree out-edges each, weights in 1..1000
+vector<Edge> random_edges(int n, int degree)
+{
+    vector<Edge> edges;
+    srand(2026);
+    for(int u=0; u<n; u++){
+        for(int k=0; k<degree; k++){
+            Edge edge = {(uint32_t)u, (uint32_t)(rand() % n),
+                (uint32_t)(1 + rand() % 1000)};
+            edges.push_back(edge);
+        }
+    }
+
+    return edges;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+
+    // Small graph
+    cout << "\n\tSmall graph" << endl;
+    Edge small_edges[] = {
+        {0, 1, 4}, {0, 7, 8}, {1, 2, 8}, {1, 7, 11}, {2, 3, 7},
+        {2, 8, 2}, {2, 5, 4}, {3, 4, 9}, {3, 5, 14}, {4, 5, 10},
+        {5, 6, 2}, {6, 7, 1}, {6, 8, 6}, {7, 8, 7}
+    };
+    CSRGraph small(9, small_edges, 14, true);
+    vector<int> dist;
+    dijkstra<NodeQueue<fibonacci::FibonacciHeap> >(small, 0, dist);
+#if DEBUG
+    cout << "Distance from 0 :";
+    for(int i=0; i<small.n; i++){
+        cout << dist[i] << " ";
+    }
+    cout << endl;
+#endif
+    cout << "MST weight :" << prim<SwapQueue<binomial::BinomialHeap> >(small) << endl;
+
+    // Load the graph, from the file in argv[1] or a random one
+    // written to a temporary file
+    cout << "\n\tLoad the binary edge list" << endl;
+    CSRGraph graph;
+    auto start = high_resolution_clock::now();
+    if(argc > 1){
+        if(!graph.load(argv[1], true)){
+            cout << "can not load " << argv[1] << endl;
+            return 1;
+        }
+    }else{
+        vector<Edge> edges = random_edges(BENCH_SCALE, 4);
+        char path[] = "/tmp/csr_graph_XXXXXX";
+        int fd = mkstemp(path);
+        if(fd < 0){
+            cout << "can not create the temporary file" << endl;
+            return 1;
+        }
+        close(fd);
+
+        bool ok = CSRGraph::save(path, BENCH_SCALE, edges.data(), edges.size());
+        start = high_resolution_clock::now();
+        ok = ok && graph.load(path, true);
+        unlink(path);
+        if(!ok){
+            cout << "can not load " << path << endl;
+            return 1;
+        }
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "vertices :" << graph.n << ", edges :" << graph.m << endl;
+    cout << "Time taken by load: "
+         << duration.count() << " microseconds" << endl;
+
+    // Dijkstra
+    cout << "\n\tDijkstra from vertex 0" << endl;
+    run_dijkstra<IndexedQueue>("IndexedBinaryHeap", graph);
+    run_dijkstra<NodeQueue<leftist::LeftistHeap> >("LeftistHeap", graph);
+    run_dijkstra<SwapQueue<binomial::BinomialHeap> >("BinomialHeap", graph);
+    run_dijkstra<NodeQueue<fibonacci::FibonacciHeap> >("FibonacciHeap", graph);
+    run_dijkstra<NodeQueue<pairing::PairingHeap> >("PairingHeap", graph);
+    run_dijkstra<NodeQueue<radix::RadixHeap> >("RadixHeap", graph);
+
+    // Prim, the keys are not monotone so the radix heap is left out
+    cout << "\n\tPrim" << endl;
+    run_prim<IndexedQueue>("IndexedBinaryHeap", graph);
+    run_prim<NodeQueue<leftist::LeftistHeap> >("LeftistHeap", graph);
+    run_prim<SwapQueue<binomial::BinomialHeap> >("BinomialHeap", graph);
+    run_prim<NodeQueue<fibonacci::FibonacciHeap> >("FibonacciHeap", graph);
+    run_prim<NodeQueue<pairing::PairingHeap> >("PairingHeap", graph);
+
+    return 0;
+}
+/*==============================================================*/
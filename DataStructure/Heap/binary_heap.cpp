@@ -3,6 +3,15 @@ Name    :binary_heap
 Author  :srhuang
 Email   :lukyandy3162@gmail.com
 History :
+    20261019 merge of indexed heaps
+    20261019 replace_min
+    20261019 opt-in operation stats
+    20261019 batched decrease-key
+    20261019 parallel heapify by subtree level
+    20261019 the key index of the indexed heap is optional
+    20261019 push_bulk and pop_k
+    20261019 d-ary heap, iterative heapify
+    20261019 indexed heap with stable handles
     20191226 decrease-key, delete, find.
     20191226 reconstruct
     20191225 decrease-key and delete
@@ -13,28 +22,67 @@ History :
 *****************************************************************/
 #include <iostream>
 #include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "heap_stats.h"
 #define DEBUG (1)
 #define SCALE (10)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#ifndef PARALLEL_GRAIN
+#define PARALLEL_GRAIN (1<<16)
+#endif
 using namespace std;
 using namespace std::chrono;
 
 /*==============================================================*/
 //Global area
+//the depth of an index in the array layout
+int level_of(int index)
+{
+    return 31 - __builtin_clz(index+1);
+}
+
 class BinaryHeap{
     //core operation
-    void Heapify(int root_index);
+    int Heapify(int root_index);
+    void HeapifyUp(int index);
+    void HeapifyAncestors(int first, int last);
+    void HeapifyParallel(int threads);
+    int popBottomUp(void);
 public:
     vector<int> data;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
 
     //five operations
     BinaryHeap(int *arr, int size);
+    BinaryHeap(int *arr, int size, int threads);
     int insert(int input);
     int extract_min();
     int minimum();
+    int replace_min(int input);
     void merge(BinaryHeap &bh);
+    void merge(BinaryHeap &bh, int threads);
+
+    //bulk operations
+    void push_bulk(int *arr, int size);
+    int pop_k(int k, int *out);
 
     //decrease-key and delete
     int decrease_key(int index, int new_val);
+    void decrease_keys(int *index, int *new_val, int count);
     void delete_key(int index);
 
     //find
@@ -45,40 +93,150 @@ public:
 };
 
 //core operation
-void BinaryHeap::Heapify(int parent_index)
+//move the hole down instead of swapping at every level,
+//return where the key ends up
+int BinaryHeap::Heapify(int parent_index)
 {
-    int left_index = 2*parent_index + 1;
-    int right_index = 2*parent_index + 2;
-    int heapify_index;
     int size = data.size();
+    int value = data[parent_index];
 
-    //check left child
-    if((left_index < size) &&
-        data[left_index] < data[parent_index])
-    {
-        heapify_index = left_index;
-    }else{
-        heapify_index = parent_index;
+    while(true){
+        int heapify_index = 2*parent_index + 1;
+        if(heapify_index >= size)
+            break;
+
+        //pick the smaller child
+        if((heapify_index+1 < size) &&
+            data[heapify_index+1] < data[heapify_index])
+        {
+            heapify_index++;
+        }
+
+        //check if need heapify
+        if(value <= data[heapify_index])
+            break;
+
+        data[parent_index] = data[heapify_index];
+        parent_index = heapify_index;
     }
+    data[parent_index] = value;
 
-    //check right child
-    if((right_index < size) &&
-        data[right_index] < data[heapify_index])
-    {
-        heapify_index = right_index;
+    return parent_index;
+}
+
+//core operation
+//move the hole up, the smaller key climbs over its ancestors
+void BinaryHeap::HeapifyUp(int index)
+{
+    int value = data[index];
+    while(index > 0){
+        int parent_index = (index-1)/2;
+        if(data[parent_index] <= value)
+            break;
+
+        data[index] = data[parent_index];
+        index = parent_index;
     }
+    data[index] = value;
+}
 
-    //check if need heapify
-    if(heapify_index != parent_index){
-        //swap
-        int temp = data[parent_index];
-        data[parent_index] = data[heapify_index];
-        data[heapify_index] = temp;
+//core operation
+//heapify only the ancestors of [first, last], level by level from the
+//bottom, every other subtree is untouched and still a heap.
+void BinaryHeap::HeapifyAncestors(int first, int last)
+{
+    while(last > 0){
+        first = (first-1)/2;
+        last = (last-1)/2;
+        for(int i=last; i>=first; i--){
+            Heapify(i);
+        }
+    }
+}
+
+//core operation
+//Floyd heapify split by subtrees. The subtrees under one level are
+//disjoint, so every thread heapifies a block of them bottom-up, depth by
+//depth, then one thread heapifies the few levels above.
+//Every thread gets at least PARALLEL_GRAIN elements.
+void BinaryHeap::HeapifyParallel(int threads)
+{
+    int size = data.size();
+    int last_parent = (size-2)/2;
+    if(threads > size / PARALLEL_GRAIN)
+        threads = size / PARALLEL_GRAIN;
+
+    //the level with about four subtrees per thread
+    int level = 0;
+    while(threads > 1 && (1 << level) < 4*threads){
+        level++;
+    }
+    int first = (1 << level) - 1;
+    if(threads <= 1 || first > last_parent){
+        for(int i=last_parent; i>=0; i--){
+            Heapify(i);
+        }
+        return;
+    }
 
-        //keep heapify
-        Heapify(heapify_index);
+    //the nodes of depth d under the roots [lo, hi) of the level are
+    //the range [(lo+1)*2^d-1, (hi+1)*2^d-1)
+    int roots = min(first+1, size-first);
+    vector<thread> workers;
+    for(int t=0; t<threads; t++){
+        long long lo = first + (long long)roots*t/threads;
+        long long hi = first + (long long)roots*(t+1)/threads;
+        workers.push_back(thread([this, lo, hi, last_parent](){
+            int depth = 0;
+            while(((lo+1) << (depth+1)) - 1 <= last_parent){
+                depth++;
+            }
+            for(int d=depth; d>=0; d--){
+                long long begin = ((lo+1) << d) - 1;
+                long long end = min(((hi+1) << d) - 2, (long long)last_parent);
+                for(long long i=end; i>=begin; i--){
+                    Heapify(i);
+                }
+            }
+        }));
+    }
+    for(int t=0; t<threads; t++){
+        workers[t].join();
     }
 
+    for(int i=first-1; i>=0; i--){
+        Heapify(i);
+    }
+}
+
+//core operation
+//extract min with one comparison per level: move the hole down to a
+//leaf along the smaller children, then sift the last element up.
+int BinaryHeap::popBottomUp(void)
+{
+    int result = data[0];
+    int last = data.back();
+    data.pop_back();
+    int size = data.size();
+    if(0 == size)
+        return result;
+
+    int hole = 0;
+    int child = 1;
+    while(child < size){
+        if(child+1 < size && data[child+1] < data[child])
+            child++;
+        data[hole] = data[child];
+        hole = child;
+        child = 2*hole + 1;
+    }
+    while(hole > 0 && data[(hole-1)/2] > last){
+        data[hole] = data[(hole-1)/2];
+        hole = (hole-1)/2;
+    }
+    data[hole] = last;
+
+    return result;
 }
 
 //initialize
@@ -91,9 +249,17 @@ BinaryHeap::BinaryHeap(int *arr, int arr_size)
     }
 }
 
+//initialize, heapify with the threads
+BinaryHeap::BinaryHeap(int *arr, int arr_size, int threads)
+{
+    data = vector<int>(arr, arr+arr_size);
+    HeapifyParallel(threads);
+}
+
 //insert
 int BinaryHeap::insert(int input)
 {
+    HEAP_STATS_OP(STATS_INSERT);
     data.push_back(input);
     int size = data.size();
     int current_index = size-1;
@@ -109,6 +275,7 @@ int BinaryHeap::insert(int input)
         current_index = (current_index-1)/2;
         parent_index = (current_index-1)/2;
     }
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(size-1) - level_of(current_index));
 
     return current_index;
 }
@@ -116,6 +283,7 @@ int BinaryHeap::insert(int input)
 //extract min
 int BinaryHeap::extract_min()
 {
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
     if(data.empty())
         return -1;
 
@@ -123,9 +291,12 @@ int BinaryHeap::extract_min()
 
     data[0] = data.back();
     data.pop_back();
+    if(data.empty())
+        return result;
 
     //heapify from the root
-    Heapify(0);
+    int last = Heapify(0);
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(last));
 
     return result;
 }
@@ -139,19 +310,106 @@ int BinaryHeap::minimum()
     return data[0];
 }
 
+//extract min and insert in one sift-down from the root, the input
+//is inserted as is when the heap is empty
+int BinaryHeap::replace_min(int input)
+{
+    HEAP_STATS_OP(STATS_REPLACE_MIN);
+    if(data.empty()){
+        data.push_back(input);
+        return -1;
+    }
+
+    int result = data[0];
+    data[0] = input;
+    int last = Heapify(0);
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(last));
+
+    return result;
+}
+
 //merge
 void BinaryHeap::merge(BinaryHeap &bh)
 {
+    HEAP_STATS_OP(STATS_MERGE);
+    data.insert(data.end(), bh.data.begin(), bh.data.end());
+    int size = data.size();
+    for(int i=(size-2)/2; i>=0; i--){
+        Heapify(i);
+    }
+}
+
+//merge, heapify with the threads
+void BinaryHeap::merge(BinaryHeap &bh, int threads)
+{
+    HEAP_STATS_OP(STATS_MERGE);
     data.insert(data.end(), bh.data.begin(), bh.data.end());
+    HeapifyParallel(threads);
+}
+
+//bulk insert
+//a small batch sifts up one by one, a large batch is appended and only
+//the ancestors of the new elements are heapified.
+void BinaryHeap::push_bulk(int *arr, int size)
+{
+    HEAP_STATS_OP(STATS_PUSH_BULK);
+    if(size <= 0)
+        return;
+
+    int old_size = data.size();
+    if((long long)size * 8 < old_size){
+        for(int i=0; i<size; i++){
+            data.push_back(arr[i]);
+            HeapifyUp(data.size()-1);
+        }
+        return;
+    }
+
+    data.insert(data.end(), arr, arr+size);
+    if(0 == old_size){
+        for(int i=(size-2)/2; i>=0; i--){
+            Heapify(i);
+        }
+    }else{
+        HeapifyAncestors(old_size, data.size()-1);
+    }
+}
+
+//extract the k minimum in order into out, return how many
+//when k log n outgrows n, select and sort the k smallest and rebuild
+//the rest once instead of sifting k times.
+int BinaryHeap::pop_k(int k, int *out)
+{
+    HEAP_STATS_OP(STATS_POP_K);
     int size = data.size();
+    if(k > size)
+        k = size;
+    if(k <= 0)
+        return 0;
+
+    if((double)k * log2(size) < size){
+        for(int i=0; i<k; i++){
+            out[i] = popBottomUp();
+        }
+        return k;
+    }
+
+    nth_element(data.begin(), data.begin()+k-1, data.end());
+    sort(data.begin(), data.begin()+k);
+    copy(data.begin(), data.begin()+k, out);
+    data.erase(data.begin(), data.begin()+k);
+    size = data.size();
     for(int i=(size-2)/2; i>=0; i--){
         Heapify(i);
     }
+
+    return k;
 }
 
 //decrease key
 int BinaryHeap::decrease_key(int index, int new_val)
 {
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
     if(index >= data.size())
         return -1;
     if(data[index] <= new_val)
@@ -172,13 +430,49 @@ int BinaryHeap::decrease_key(int index, int new_val)
         current_index = (current_index-1)/2;
         parent_index = (current_index-1)/2;
     }
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(index) - level_of(current_index));
 
     return current_index;
 }
 
+//batched decrease key
+//the indices are positions before the batch. All the keys are written
+//first, then a small batch sifts the touched positions up in increasing
+//order and a large one rebuilds the whole array.
+//A sift-up only moves the ancestors of the position, which are at
+//smaller indices, so the later positions stay where they are.
+void BinaryHeap::decrease_keys(int *index, int *new_val, int count)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    int size = data.size();
+    vector<int> touched;
+    for(int i=0; i<count; i++){
+        if(index[i] < 0 || index[i] >= size || data[index[i]] <= new_val[i])
+            continue;
+
+        data[index[i]] = new_val[i];
+        touched.push_back(index[i]);
+    }
+    if(touched.empty())
+        return;
+
+    if((double)touched.size() * log2(size) >= size){
+        for(int i=(size-2)/2; i>=0; i--){
+            Heapify(i);
+        }
+        return;
+    }
+
+    sort(touched.begin(), touched.end());
+    for(int i=0; i<(int)touched.size(); i++){
+        HeapifyUp(touched[i]);
+    }
+}
+
 //delete
 void BinaryHeap::delete_key(int index)
 {
+    HEAP_STATS_OP(STATS_DELETE);
     if(index >= data.size())
         return;
 
@@ -228,6 +522,607 @@ void BinaryHeap::dump(void)
     cout << endl;
 }
 
+//Indexed binary heap
+//insert returns a handle instead of an array index, the handle keeps
+//pointing to the same element until it is extracted or deleted.
+class IndexedBinaryHeap{
+    //core operation
+    int siftUp(int index);
+    int siftDown(int index);
+    void place(int index, int handle);
+    void release(int handle);
+    void rekey(int handle, int new_val);
+public:
+    vector<int> heap;       //handle at each heap position
+    vector<int> key;        //key of each handle
+    vector<int> position;   //heap position of each handle, -1 if free
+    vector<int> free_handle;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //optional key -> handle, for O(1) find
+    bool indexed=false;
+    unordered_multimap<int, int> key_index;
+    void enable_index(void);
+
+    //operations
+    IndexedBinaryHeap();
+    IndexedBinaryHeap(int *arr, int size);
+    int insert(int input);
+    int extract_min();
+    int minimum();
+    int min_handle();
+    int size();
+
+    //merge, the other heap is emptied, moved maps its old handles
+    void merge(IndexedBinaryHeap &other, vector<int> &moved);
+
+    //decrease-key and delete by handle
+    int decrease_key(int handle, int new_val);
+    void decrease_keys(int *handle, int *new_val, int count);
+    void delete_key(int handle);
+
+    //find the handle of the key
+    int find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+//put the handle at the index and keep the position map
+void IndexedBinaryHeap::place(int index, int handle)
+{
+    heap[index] = handle;
+    position[handle] = index;
+}
+
+//give back the handle and drop it from the key index
+void IndexedBinaryHeap::release(int handle)
+{
+    if(indexed){
+        auto range = key_index.equal_range(key[handle]);
+        for(auto it=range.first; it!=range.second; it++){
+            if(it->second == handle){
+                key_index.erase(it);
+                break;
+            }
+        }
+    }
+    position[handle] = -1;
+    free_handle.push_back(handle);
+}
+
+//set the key of the handle and re-key the index
+void IndexedBinaryHeap::rekey(int handle, int new_val)
+{
+    if(indexed){
+        auto range = key_index.equal_range(key[handle]);
+        for(auto it=range.first; it!=range.second; it++){
+            if(it->second == handle){
+                key_index.erase(it);
+                break;
+            }
+        }
+        key_index.insert({new_val, handle});
+    }
+
+    key[handle] = new_val;
+}
+
+//core operation, move the hole up instead of swapping,
+//return where the key ends up
+int IndexedBinaryHeap::siftUp(int index)
+{
+    int handle = heap[index];
+    int value = key[handle];
+
+    while(index > 0){
+        int parent_index = (index-1)/2;
+        if(key[heap[parent_index]] <= value)
+            break;
+
+        place(index, heap[parent_index]);
+        index = parent_index;
+    }
+    place(index, handle);
+
+    return index;
+}
+
+//core operation, move the hole down instead of swapping,
+//return where the key ends up
+int IndexedBinaryHeap::siftDown(int index)
+{
+    int size = heap.size();
+    int handle = heap[index];
+    int value = key[handle];
+
+    while(true){
+        int child_index = 2*index + 1;
+        if(child_index >= size)
+            break;
+
+        //pick the smaller child
+        if(child_index+1 < size &&
+            key[heap[child_index+1]] < key[heap[child_index]])
+        {
+            child_index++;
+        }
+
+        if(value <= key[heap[child_index]])
+            break;
+
+        place(index, heap[child_index]);
+        index = child_index;
+    }
+    place(index, handle);
+
+    return index;
+}
+
+IndexedBinaryHeap::IndexedBinaryHeap()
+{
+
+}
+
+//initialize, handle i is the i-th element of the array
+IndexedBinaryHeap::IndexedBinaryHeap(int *arr, int arr_size)
+{
+    heap.resize(arr_size);
+    key = vector<int>(arr, arr+arr_size);
+    position.resize(arr_size);
+    for(int i=0; i<arr_size; i++){
+        place(i, i);
+    }
+
+    for(int i=(arr_size-2)/2; i>=0; i--){
+        siftDown(i);
+    }
+}
+
+//insert
+int IndexedBinaryHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    int handle;
+    if(free_handle.empty()){
+        handle = key.size();
+        key.push_back(input);
+        position.push_back(-1);
+    }else{
+        handle = free_handle.back();
+        free_handle.pop_back();
+        key[handle] = input;
+    }
+    if(indexed){
+        key_index.insert({input, handle});
+    }
+
+    heap.push_back(handle);
+    position[handle] = heap.size()-1;
+    int last = siftUp(heap.size()-1);
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(heap.size()-1) - level_of(last));
+
+    return handle;
+}
+
+//extract min
+int IndexedBinaryHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(heap.empty())
+        return -1;
+
+    int handle = heap[0];
+    int result = key[handle];
+    release(handle);
+
+    int last = heap.back();
+    heap.pop_back();
+    if(!heap.empty()){
+        place(0, last);
+        int index = siftDown(0);
+        HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(index));
+    }
+
+    return result;
+}
+
+//minimum
+int IndexedBinaryHeap::minimum()
+{
+    if(heap.empty())
+        return -1;
+
+    return key[heap[0]];
+}
+
+//the handle of the minimum
+int IndexedBinaryHeap::min_handle()
+{
+    if(heap.empty())
+        return -1;
+
+    return heap[0];
+}
+
+int IndexedBinaryHeap::size()
+{
+    return heap.size();
+}
+
+//merge
+//every element of the other heap gets a handle here and is appended,
+//then one heapify over the whole array, O(n+m).
+void IndexedBinaryHeap::merge(IndexedBinaryHeap &other, vector<int> &moved)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    moved.assign(other.key.size(), -1);
+    for(int i=0; i<(int)other.heap.size(); i++){
+        int old = other.heap[i];
+        int input = other.key[old];
+        int handle;
+        if(free_handle.empty()){
+            handle = key.size();
+            key.push_back(input);
+            position.push_back(-1);
+        }else{
+            handle = free_handle.back();
+            free_handle.pop_back();
+            key[handle] = input;
+        }
+        if(indexed){
+            key_index.insert({input, handle});
+        }
+
+        heap.push_back(handle);
+        position[handle] = heap.size()-1;
+        moved[old] = handle;
+    }
+
+    int size = heap.size();
+    for(int i=(size-2)/2; i>=0; i--){
+        siftDown(i);
+    }
+
+    other.heap.clear();
+    other.key.clear();
+    other.position.clear();
+    other.free_handle.clear();
+    other.key_index.clear();
+}
+
+//decrease key
+int IndexedBinaryHeap::decrease_key(int handle, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(handle < 0 || handle >= (int)key.size() || position[handle] < 0)
+        return -1;
+    if(key[handle] <= new_val)
+        return handle;
+
+    rekey(handle, new_val);
+    int index = position[handle];
+    int last = siftUp(index);
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level_of(index) - level_of(last));
+
+    return handle;
+}
+
+//batched decrease key, the same two ways as BinaryHeap
+void IndexedBinaryHeap::decrease_keys(int *handle, int *new_val, int count)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    int size = heap.size();
+    vector<int> touched;
+    for(int i=0; i<count; i++){
+        int h = handle[i];
+        if(h < 0 || h >= (int)key.size() || position[h] < 0 || key[h] <= new_val[i])
+            continue;
+
+        rekey(h, new_val[i]);
+        touched.push_back(position[h]);
+    }
+    if(touched.empty())
+        return;
+
+    if((double)touched.size() * log2(size) >= size){
+        for(int i=(size-2)/2; i>=0; i--){
+            siftDown(i);
+        }
+        return;
+    }
+
+    sort(touched.begin(), touched.end());
+    for(int i=0; i<(int)touched.size(); i++){
+        siftUp(touched[i]);
+    }
+}
+
+//delete
+void IndexedBinaryHeap::delete_key(int handle)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(handle < 0 || handle >= (int)key.size() || position[handle] < 0)
+        return;
+
+    int index = position[handle];
+    release(handle);
+
+    int last = heap.back();
+    heap.pop_back();
+    if(index == (int)heap.size())
+        return;
+
+    //the last element fills the hole, it may go either way
+    place(index, last);
+    if(index > 0 && key[last] < key[heap[(index-1)/2]]){
+        siftUp(index);
+    }else{
+        siftDown(index);
+    }
+}
+
+//find
+int IndexedBinaryHeap::find(int search_key)
+{
+    if(!indexed){
+        int size = heap.size();
+        for(int i=0; i<size; i++){
+            if(key[heap[i]] == search_key)
+                return heap[i];
+        }
+        return -1;
+    }
+
+    auto it = key_index.find(search_key);
+    if(it == key_index.end())
+        return -1;
+
+    return it->second;
+}
+
+//build the key index from the live handles, it is kept from now on.
+//Many equal keys make the index slow, e.g. the distances in Dijkstra.
+void IndexedBinaryHeap::enable_index(void)
+{
+    if(indexed)
+        return;
+
+    indexed = true;
+    key_index.reserve(heap.size());
+    for(int i=0; i<(int)heap.size(); i++){
+        key_index.insert({key[heap[i]], heap[i]});
+    }
+}
+
+//dump
+void IndexedBinaryHeap::dump(void)
+{
+    int size = heap.size();
+    cout << "Dump the heap : ";
+    for(int i=0; i<size; i++){
+        cout << key[heap[i]] << "[" << heap[i] << "] ";
+    }
+    cout << endl;
+}
+
+//d-ary heap, D is 4 or 8
+//logical index i is keys[i] and keys starts D-1 slots into an aligned
+//buffer, so i lives at buffer[i + D - 1], the children of i start at
+//buffer[D*(i+1)] and every sibling group sits in one cache line.
+//The slots after the last element hold INT_MAX, the minimum child is
+//always picked from a full group with one SIMD min-reduction.
+//(build with -march=native to get the AVX2/SSE4.1 path)
+template<int D>
+class DaryHeap{
+    //core operation
+    int siftUp(int index, int value);
+    int siftDown(int index, int value);
+    int minChild(int index, int &value);
+    void reserve(int capacity);
+
+    int *buffer=NULL;
+    int *keys=NULL;     //logical index 0 is keys[0]
+    int capacity=0;
+public:
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    DaryHeap();
+    DaryHeap(int *arr, int size);
+    ~DaryHeap();
+
+    //the buffer is owned, a copy would free it twice
+    DaryHeap(const DaryHeap &) = delete;
+    DaryHeap &operator=(const DaryHeap &) = delete;
+    void insert(int input);
+    int extract_min();
+    int minimum();
+
+    //dump elements
+    void dump(void);
+};
+
+template<int D>
+DaryHeap<D>::DaryHeap()
+{
+    reserve(64);
+}
+
+template<int D>
+DaryHeap<D>::~DaryHeap()
+{
+    free(buffer);
+}
+
+//grow the aligned buffer, the padding slots are INT_MAX
+template<int D>
+void DaryHeap<D>::reserve(int new_capacity)
+{
+    //physical slots: D-1 in front, rounded up to whole groups plus one
+    int slots = (new_capacity + D - 1 + D - 1) / D * D + D;
+    int *new_buffer = (int *)aligned_alloc(64, ((slots*sizeof(int)+63)/64)*64);
+    for(int i=0; i<slots; i++){
+        new_buffer[i] = INT_MAX;
+    }
+    if(buffer){
+        memcpy(new_buffer + D - 1, keys, number*sizeof(int));
+        free(buffer);
+    }
+    buffer = new_buffer;
+    keys = buffer + D - 1;
+    capacity = new_capacity;
+}
+
+//index of the smallest child of the index, and its value
+template<int D>
+int DaryHeap<D>::minChild(int index, int &value)
+{
+    int first = D*index + 1;
+    const int *group = keys + first;
+#if defined(__AVX2__)
+    if(D == 8){
+        __m256i v = _mm256_load_si256((const __m256i *)group);
+        __m256i m = _mm256_min_epi32(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2,3,0,1)));
+        m = _mm256_min_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1,0,3,2)));
+        m = _mm256_min_epi32(m, _mm256_permute2x128_si256(m, m, 1));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, m)));
+        value = _mm_cvtsi128_si32(_mm256_castsi256_si128(m));
+        return first + __builtin_ctz(mask);
+    }
+#endif
+#if defined(__SSE4_1__)
+    if(D == 4){
+        __m128i v = _mm_load_si128((const __m128i *)group);
+        __m128i m = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2,3,0,1)));
+        m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1,0,3,2)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, m)));
+        value = _mm_cvtsi128_si32(m);
+        return first + __builtin_ctz(mask);
+    }
+#endif
+    int result = 0;
+    value = group[0];
+    for(int i=1; i<D; i++){
+        if(group[i] < value){
+            value = group[i];
+            result = i;
+        }
+    }
+    return first + result;
+}
+
+//core operation, the hole moves up, return the levels it moved
+template<int D>
+int DaryHeap<D>::siftUp(int index, int value)
+{
+    int levels = 0;
+    while(index > 0){
+        int parent_index = (index-1)/D;
+        if(keys[parent_index] <= value)
+            break;
+
+        keys[index] = keys[parent_index];
+        index = parent_index;
+        levels++;
+    }
+    keys[index] = value;
+
+    return levels;
+}
+
+//core operation, the hole moves down, return the levels it moved
+template<int D>
+int DaryHeap<D>::siftDown(int index, int value)
+{
+    int levels = 0;
+    while(D*index + 1 < number){
+        int child_value;
+        int child_index = minChild(index, child_value);
+        if(value <= child_value)
+            break;
+
+        keys[index] = child_value;
+        index = child_index;
+        levels++;
+    }
+    keys[index] = value;
+
+    return levels;
+}
+
+//initialize
+template<int D>
+DaryHeap<D>::DaryHeap(int *arr, int size)
+{
+    reserve(size > 64 ? size : 64);
+    memcpy(keys, arr, size*sizeof(int));
+    number = size;
+    for(int i=(size-2)/D; i>=0; i--){
+        siftDown(i, keys[i]);
+    }
+}
+
+//insert
+template<int D>
+void DaryHeap<D>::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    if(number == capacity)
+        reserve(2*capacity);
+
+    number++;
+    int levels = siftUp(number-1, input);
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, levels);
+}
+
+//extract min
+template<int D>
+int DaryHeap<D>::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(0 == number)
+        return -1;
+
+    int result = keys[0];
+    int last = keys[number-1];
+
+    //keep the padding for the SIMD group load
+    keys[number-1] = INT_MAX;
+    number--;
+    if(number > 0){
+        int levels = siftDown(0, last);
+        HEAP_STATS_RECORD(STATS_SIFT_DEPTH, levels);
+    }
+
+    return result;
+}
+
+//minimum
+template<int D>
+int DaryHeap<D>::minimum()
+{
+    if(0 == number)
+        return -1;
+
+    return keys[0];
+}
+
+//dump
+template<int D>
+void DaryHeap<D>::dump(void)
+{
+    cout << "Dump the heap : ";
+    for(int i=0; i<number; i++){
+        cout << keys[i] << " ";
+    }
+    cout << endl;
+}
+
 /*==============================================================*/
 //Function area
 int *random_case(int base, int number)
@@ -242,7 +1137,7 @@ int *random_case(int base, int number)
     //swap each position
     srand(time(NULL));
     for(int i=0; i<number-1; i++){
-        int j = i + rand() / (RAND_MAX / (number-i));
+        int j = i + rand() % (number-i);
         //swap
         int t=result[i];
         result[i] = result[j];
@@ -285,6 +1180,8 @@ int main(int argc, char const *argv[]){
     cout << "extract_min :" << myHeap.extract_min() << endl;
     myHeap.dump();
     cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "replace_min with 9 :" << myHeap.replace_min(9) << endl;
+    myHeap.dump();
 
     // Test decrease-key and delete
     cout << "\n\tTest decrease-key and delete" << endl;
@@ -329,6 +1226,244 @@ int main(int argc, char const *argv[]){
     }
     cout << endl;
 
+    // Indexed heap with stable handles
+    cout << "\n\tIndexed heap with stable handles" << endl;
+    int *random_data3 = random_case(1, n);
+    IndexedBinaryHeap myIndexedHeap(random_data3, n);
+    myIndexedHeap.dump();
+    int handle = myIndexedHeap.insert(8);
+    myIndexedHeap.insert(0);
+    cout << "insert 8 as handle " << handle << ", insert 0" << endl;
+    myIndexedHeap.dump();
+    myIndexedHeap.decrease_key(handle, -1);
+    cout << "decrease-key handle " << handle << " to -1" << endl;
+    myIndexedHeap.dump();
+    cout << "find 5 :" << myIndexedHeap.find(5) << endl;
+    myIndexedHeap.delete_key(myIndexedHeap.find(5));
+    cout << "delete 5" << endl;
+    myIndexedHeap.dump();
+    IndexedBinaryHeap myIndexedHeap2;
+    int other = myIndexedHeap2.insert(-5);
+    myIndexedHeap2.insert(30);
+    vector<int> moved;
+    myIndexedHeap.merge(myIndexedHeap2, moved);
+    cout << "merge -5 and 30, handle " << other << " is now " << moved[other] << endl;
+    myIndexedHeap.dump();
+    cout << "Heap sort :";
+    while(myIndexedHeap.size()){
+        cout << myIndexedHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark find and decrease-key
+    cout << "\n\tBenchmark find and decrease-key" << endl;
+    int bench_n = BENCH_SCALE;
+    int bench_q = 1000;
+    int *bench_data = random_case(1, bench_n);
+    BinaryHeap benchHeap(bench_data, bench_n);
+    IndexedBinaryHeap benchIndexedHeap(bench_data, bench_n);
+    benchIndexedHeap.enable_index();
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    for(int i=0; i<bench_q; i++){
+        checksum += benchHeap.find(bench_data[i]);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << bench_q << " linear find: "
+         << duration.count() << " microseconds" << endl;
+
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_q; i++){
+        checksum += benchIndexedHeap.find(bench_data[i]);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << bench_q << " indexed find: "
+         << duration.count() << " microseconds" << endl;
+
+    //find then decrease-key, the way a Dijkstra relax step does
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_q; i++){
+        int index = benchHeap.find(bench_data[i]);
+        benchHeap.decrease_key(index, -i);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << bench_q << " find + decrease-key: "
+         << duration.count() << " microseconds" << endl;
+
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_q; i++){
+        benchIndexedHeap.decrease_key(i, -i);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << bench_q << " handle decrease-key: "
+         << duration.count() << " microseconds" << endl;
+    cout << "checksum :" << checksum << endl;
+
+    // d-ary heap
+    cout << "\n\td-ary heap" << endl;
+    DaryHeap<4> myDaryHeap(random_data, n);
+    myDaryHeap.insert(0);
+    myDaryHeap.dump();
+    cout << "Heap sort :";
+    while(myDaryHeap.number){
+        cout << myDaryHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark pop-heavy throughput
+    cout << "\n\tBenchmark pop-heavy throughput" << endl;
+    int *pop_data = random_case(1, bench_n);
+    BinaryHeap popHeap(pop_data, bench_n);
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_n; i++){
+        checksum += popHeap.extract_min();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by binary heap extract_min: "
+         << duration.count() << " microseconds" << endl;
+
+    DaryHeap<4> popHeap4(pop_data, bench_n);
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_n; i++){
+        checksum += popHeap4.extract_min();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by 4-ary heap extract_min: "
+         << duration.count() << " microseconds" << endl;
+
+    DaryHeap<8> popHeap8(pop_data, bench_n);
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_n; i++){
+        checksum += popHeap8.extract_min();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by 8-ary heap extract_min: "
+         << duration.count() << " microseconds" << endl;
+    cout << "checksum :" << checksum << endl;
+
+    // Bulk insert and batched extract
+    cout << "\n\tBulk insert and batched extract" << endl;
+    BinaryHeap myBulkHeap(random_data, n);
+    myBulkHeap.push_bulk(random_data2, n);
+    myBulkHeap.dump();
+    int out[SCALE];
+    int out_k = myBulkHeap.pop_k(5, out);
+    cout << "pop_k :";
+    for(int i=0; i<out_k; i++){
+        cout << out[i] << " ";
+    }
+    cout << endl;
+    myBulkHeap.dump();
+
+    // Benchmark bulk insert and batched extract
+    cout << "\n\tBenchmark bulk insert and batched extract" << endl;
+    int batch_sizes[] = {16, 1024, bench_n/4};
+    int *batch_out = new int[bench_n];
+    for(int b=0; b<3; b++){
+        int batch = batch_sizes[b];
+        int rounds = bench_n / batch;
+        cout << "batch size " << batch << " :" << endl;
+
+        BinaryHeap loopHeap(pop_data, bench_n/2);
+        start = high_resolution_clock::now();
+        for(int r=0; r<rounds; r++){
+            for(int i=0; i<batch; i++){
+                loopHeap.insert(pop_data[(r*batch+i) % bench_n]);
+            }
+            for(int i=0; i<batch; i++){
+                batch_out[i] = loopHeap.extract_min();
+            }
+        }
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by insert/extract_min loops: "
+             << duration.count() << " microseconds" << endl;
+        checksum += batch_out[batch-1];
+
+        BinaryHeap bulkHeap(pop_data, bench_n/2);
+        start = high_resolution_clock::now();
+        for(int r=0; r<rounds; r++){
+            bulkHeap.push_bulk(pop_data + (r*batch) % bench_n, batch);
+            bulkHeap.pop_k(batch, batch_out);
+        }
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by push_bulk/pop_k: "
+             << duration.count() << " microseconds" << endl;
+        checksum += batch_out[batch-1];
+    }
+    cout << "checksum :" << checksum << endl;
+
+    // Benchmark parallel heapify
+    //build with -DBENCH_SCALE=100000000 for the startup-size heap
+    cout << "\n\tBenchmark parallel heapify" << endl;
+    int bench_threads = max(4u, thread::hardware_concurrency());
+    checksum = 0;
+
+    start = high_resolution_clock::now();
+    BinaryHeap serialHeap(bench_data, bench_n);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by serial heapify: "
+         << duration.count() << " microseconds" << endl;
+    checksum += serialHeap.extract_min();
+
+    start = high_resolution_clock::now();
+    BinaryHeap parallelHeap(bench_data, bench_n, bench_threads);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by parallel heapify, " << bench_threads << " threads: "
+         << duration.count() << " microseconds" << endl;
+    checksum += parallelHeap.extract_min();
+    cout << "checksum :" << checksum << endl;
+
+    // Benchmark batched decrease-key
+    cout << "\n\tBenchmark batched decrease-key" << endl;
+    int update_sizes[] = {1000, bench_n/10, bench_n/2};
+    int *update_val = new int[bench_n];
+    checksum = 0;
+    for(int b=0; b<3; b++){
+        int batch = update_sizes[b];
+        for(int i=0; i<batch; i++){
+            update_val[i] = -bench_data[i];
+        }
+
+        IndexedBinaryHeap loopHeap(bench_data, bench_n);
+        start = high_resolution_clock::now();
+        for(int i=0; i<batch; i++){
+            loopHeap.decrease_key(bench_data[i] - 1, update_val[i]);
+        }
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by " << batch << " decrease_key: "
+             << duration.count() << " microseconds" << endl;
+        checksum += loopHeap.extract_min();
+
+        //bench_data[i]-1 over i is a permutation of the handles
+        IndexedBinaryHeap batchHeap(bench_data, bench_n);
+        int *update_handle = new int[batch];
+        for(int i=0; i<batch; i++){
+            update_handle[i] = bench_data[i] - 1;
+        }
+        start = high_resolution_clock::now();
+        batchHeap.decrease_keys(update_handle, update_val, batch);
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by decrease_keys of " << batch << ": "
+             << duration.count() << " microseconds" << endl;
+        checksum += batchHeap.extract_min();
+        delete[] update_handle;
+    }
+    cout << "checksum :" << checksum << endl;
+
     return 0;
 }
 /*==============================================================*/
\ No newline at end of file
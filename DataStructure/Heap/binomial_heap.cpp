@@ -3,6 +3,14 @@ Name    :binomial_heap
 Author  :srhuang
 Email   :lukyandy3162@gmail.com
 History :
+    20261019 delete does not count an extract_min too
+    20261019 stats for every heap
+    20261019 opt-in operation stats
+    20261019 parallel construction by pairwise merge
+    20261019 lazy binomial heap
+    20261019 array-of-roots heap with a tournament for the min
+    20261019 optional hash index for find
+    20261019 O(n) bulk construction
     20200108 delete
     20200107 decrease key and fix minNode bug
     20200107 find
@@ -11,8 +19,19 @@ History :
 *****************************************************************/
 #include <iostream>
 #include <vector>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include "key_index.h"
+#include "heap_stats.h"
 #define DEBUG (1)
 #define SCALE (13)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#ifndef PARALLEL_GRAIN
+#define PARALLEL_GRAIN (1<<16)
+#endif
 using namespace std;
 using namespace std::chrono;
 
@@ -34,19 +53,38 @@ class BinomialHeap{
     //core operation
     Node *treeUnion(Node *n1, Node *n2); //must be the same degree
     void heapUnion(bool isinsert); //handle with tree union
+    int removeMin(void);
 
     //preorder traversal
     void preorderTraversal(Node *current);
 
     //preorder find
     Node *preorderFind(Node *current, int key);
+
+    //add every node of the tree into the index
+    void indexTree(Node *current);
+
+    //merge without touching the index
+    void meld(BinomialHeap &bh);
+
+    //the keys change nodes by a value swap
+    void swapData(Node *n1, Node *n2);
 public:
     Node *minNode=NULL;
     Node *head=NULL;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //optional key -> node index
+    bool indexed=false;
+    KeyIndex<Node> index;
+    void enable_index(void);
 
     //five operations
     BinomialHeap();
     BinomialHeap(int *arr, int size);
+    BinomialHeap(int *arr, int size, int threads);
     Node *insert(int input);
     int extract_min();
     int minimum();
@@ -137,16 +175,93 @@ void BinomialHeap::heapUnion(bool isinsert)
 }
 
 //Initialize
+//count the elements like a binary counter, trees[k] holds the B(k) of
+//bit k, so the trees end up matching the binary representation of size.
+//Every element costs O(1) amortized tree unions and the root list and
+//min node are built once at the end, the whole build is O(n).
 BinomialHeap::BinomialHeap(int *arr, int size)
 {
+    Node *trees[32] = {NULL};
+
     for(int i=0; i<size; i++){
-        insert(arr[i]);
+        Node *carry = new Node();
+        carry->data = arr[i];
+
+        int degree = 0;
+        while(trees[degree]){
+            carry = treeUnion(trees[degree], carry);
+            trees[degree] = NULL;
+            degree++;
+        }
+        trees[degree] = carry;
+    }
+
+    //the root list is in increasing degree
+    Node *tail = NULL;
+    for(int degree=0; degree<32; degree++){
+        if(NULL == trees[degree])
+            continue;
+
+        if(NULL == tail){
+            head = trees[degree];
+        }else{
+            tail->sibling = trees[degree];
+        }
+        tail = trees[degree];
+
+        //keep tracking the min node
+        if(NULL == minNode || tail->data < minNode->data){
+            minNode = tail;
+        }
+    }
+}
+
+//Initialize in parallel
+//every thread builds the heap of one slice with the binary counter,
+//then the heaps are merged pairwise round by round, the pairs of one
+//round merge in parallel.
+BinomialHeap::BinomialHeap(int *arr, int size, int threads)
+{
+    if(threads > size / PARALLEL_GRAIN)
+        threads = size / PARALLEL_GRAIN;
+    if(threads < 1)
+        threads = 1;
+
+    vector<BinomialHeap*> part(threads);
+    vector<thread> workers;
+    for(int t=0; t<threads; t++){
+        int lo = (long long)size*t/threads;
+        int hi = (long long)size*(t+1)/threads;
+        workers.push_back(thread([&part, arr, t, lo, hi](){
+            part[t] = new BinomialHeap(arr+lo, hi-lo);
+        }));
+    }
+    for(int t=0; t<threads; t++){
+        workers[t].join();
+    }
+
+    for(int step=1; step<threads; step*=2){
+        workers.clear();
+        for(int t=0; t+step<threads; t+=2*step){
+            workers.push_back(thread([&part, t, step](){
+                part[t]->merge(*part[t+step]);
+            }));
+        }
+        for(int i=0; i<(int)workers.size(); i++){
+            workers[i].join();
+        }
+    }
+
+    merge(*part[0]);
+    for(int t=0; t<threads; t++){
+        delete part[t];
     }
 }
 
 //insert
 Node *BinomialHeap::insert(int input)
 {
+    HEAP_STATS_OP(STATS_INSERT);
     Node *newNode = new Node();
     newNode->data = input;
 
@@ -156,18 +271,18 @@ Node *BinomialHeap::insert(int input)
     }
     head = newNode;
 
+    if(indexed)
+        index.insert(input, newNode);
+
     //adjust the binomial heap
     heapUnion(true);
 
     return newNode;
 }
 
-//extract_min
-int BinomialHeap::extract_min()
+//core operation, remove the min node, shared by extract_min and delete
+int BinomialHeap::removeMin(void)
 {
-    if(NULL==head)
-        return -1;
-
     Node *target = minNode;
     int result = minNode->data;
 
@@ -190,11 +305,13 @@ int BinomialHeap::extract_min()
     }
 
     //update the minNode
+    int roots = 0;
     current = head;
     minNode = head;
     while(current){
         minNode = (current->data < minNode->data) ? current : minNode;
         current = current->sibling;
+        roots++;
     }
 
     //reverse the sibling list
@@ -207,6 +324,7 @@ int BinomialHeap::extract_min()
         //update the minNode
         if(current->data < tempMinNode->data)
             tempMinNode = current;
+        roots++;
 
         next = current->sibling;
         current->parent = NULL;
@@ -222,16 +340,29 @@ int BinomialHeap::extract_min()
         bh.head = pre;
         bh.minNode = tempMinNode;
         //merge with updating the min Node
-        merge(bh);
+        meld(bh);
     }
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, roots);
 
     //delete the min Node
+    if(indexed)
+        index.erase(result, target);
     delete target;
     target = NULL;
 
     return result;
 }
 
+//extract_min
+int BinomialHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NULL==head)
+        return -1;
+
+    return removeMin();
+}
+
 //minimum
 int BinomialHeap::minimum()
 {
@@ -243,6 +374,16 @@ int BinomialHeap::minimum()
 
 //merge
 void BinomialHeap::merge(BinomialHeap &bh)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    if(indexed && bh.head)
+        indexTree(bh.head);
+
+    meld(bh);
+}
+
+//merge the root lists, the nodes of bh are already in the index
+void BinomialHeap::meld(BinomialHeap &bh)
 {
     if(NULL == head){
         head = bh.head;
@@ -298,24 +439,36 @@ void BinomialHeap::merge(BinomialHeap &bh)
 //decrease key
 Node *BinomialHeap::decrease_key(Node *input, int new_val)
 {
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
     if(NULL == input)
         return NULL;
     if(input->data <= new_val)
         return input;
 
+    if(indexed){
+        index.erase(input->data, input);
+        index.insert(new_val, input);
+    }
+
     input->data = new_val;
     Node *current = input;
     Node *parent = current->parent;
+    int levels = 0;
     while(parent && parent->data > current->data)
     {
         //swap
-        int temp = current->data;
-        current->data = parent->data;
-        parent->data = temp;
+        swapData(current, parent);
 
         //bottom-up
         current = parent;
         parent = current->parent;
+        levels++;
+    }
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, levels);
+
+    //the key may reach a root below the min node
+    if(current->data < minNode->data){
+        minNode = current;
     }
 
     return current;
@@ -324,6 +477,7 @@ Node *BinomialHeap::decrease_key(Node *input, int new_val)
 //delete
 void BinomialHeap::delete_key(Node *input)
 {
+    HEAP_STATS_OP(STATS_DELETE);
     if(NULL == input)
         return;
 
@@ -332,9 +486,7 @@ void BinomialHeap::delete_key(Node *input)
     while(parent)
     {
         //swap
-        int temp = current->data;
-        current->data = parent->data;
-        parent->data = temp;
+        swapData(current, parent);
 
         //bottom-up
         current = parent;
@@ -343,7 +495,41 @@ void BinomialHeap::delete_key(Node *input)
 
     //extract min
     minNode = current;
-    extract_min();
+    removeMin();
+}
+
+//swap the data of two nodes and keep the index
+void BinomialHeap::swapData(Node *n1, Node *n2)
+{
+    if(indexed){
+        index.relink(n1->data, n1, n2);
+        index.relink(n2->data, n2, n1);
+    }
+
+    int temp = n1->data;
+    n1->data = n2->data;
+    n2->data = temp;
+}
+
+//preorder over the tree and its siblings
+void BinomialHeap::indexTree(Node *current)
+{
+    while(current){
+        index.insert(current->data, current);
+        indexTree(current->child);
+        current = current->sibling;
+    }
+}
+
+//build the index of the current nodes, kept up to date from now on
+void BinomialHeap::enable_index(void)
+{
+    if(indexed)
+        return;
+
+    indexed = true;
+    index.clear();
+    indexTree(head);
 }
 
 //binary tree preorder find
@@ -373,6 +559,9 @@ Node *BinomialHeap::preorderFind(Node *current, int key)
 //find
 Node *BinomialHeap::find(int key)
 {
+    if(indexed)
+        return index.find(key);
+
     if(NULL == head)
         return NULL;
 
@@ -424,6 +613,590 @@ void BinomialHeap::dump(void)
     }
 }
 
+//Array-of-roots binomial heap
+//roots[k] is the B(k) tree or NULL, trees are merged like a binary
+//addition with carry, and the min root is the winner of a tournament
+//over the 64 slots, so extract_min walks no root list.
+class ArrayBinomialHeap{
+    //core operation
+    Node *link(Node *n1, Node *n2);
+    void add(Node **trees, int max_degree);
+    int removeRoot(int degree);
+
+    //tournament, leaves are tree[64+degree], tree[1] is the min degree
+    int tree[128];
+    void update(int degree);
+public:
+    Node *roots[64];
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    ArrayBinomialHeap();
+    ArrayBinomialHeap(int *arr, int size);
+    Node *insert(int input);
+    int extract_min();
+    int minimum();
+    void merge(ArrayBinomialHeap &abh);
+
+    //decrease-key and delete
+    Node *decrease_key(Node *input, int new_val);
+    void delete_key(Node *input);
+
+    //find
+    Node *find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+ArrayBinomialHeap::ArrayBinomialHeap()
+{
+    for(int i=0; i<64; i++){
+        roots[i] = NULL;
+    }
+    for(int i=0; i<128; i++){
+        tree[i] = -1;
+    }
+}
+
+//Initialize
+ArrayBinomialHeap::ArrayBinomialHeap(int *arr, int size) : ArrayBinomialHeap()
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//core operation, must be the same degree
+Node *ArrayBinomialHeap::link(Node *n1, Node *n2)
+{
+    Node *less = (n2->data < n1->data)? n2 : n1;
+    Node *greater = (n1 == less)? n2 : n1;
+
+    greater->parent = less;
+    greater->sibling = less->child;
+    less->child = greater;
+    less->degree++;
+
+    return less;
+}
+
+//replay the matches from the leaf of the degree up to the top
+void ArrayBinomialHeap::update(int degree)
+{
+    int i = 64 + degree;
+    tree[i] = roots[degree] ? degree : -1;
+
+    for(i/=2; i>=1; i/=2){
+        int d1 = tree[2*i];
+        int d2 = tree[2*i+1];
+        if(d1 < 0){
+            tree[i] = d2;
+        }else if(d2 < 0){
+            tree[i] = d1;
+        }else{
+            tree[i] = (roots[d2]->data < roots[d1]->data) ? d2 : d1;
+        }
+    }
+}
+
+//core operation
+//add trees[0..max_degree] into the roots, like a binary addition
+void ArrayBinomialHeap::add(Node **trees, int max_degree)
+{
+    Node *carry = NULL;
+    for(int d=0; d<64; d++){
+        if(d > max_degree && NULL == carry)
+            break;
+
+        Node *other = (d <= max_degree) ? trees[d] : NULL;
+        if(NULL == other && NULL == carry)
+            continue;
+
+        Node *sum[3] = {NULL, NULL, NULL};
+        int count = 0;
+        if(roots[d]) sum[count++] = roots[d];
+        if(other) sum[count++] = other;
+        if(carry) sum[count++] = carry;
+
+        //one tree stays, a pair is carried to the next degree
+        if(1 == count){
+            roots[d] = sum[0];
+            carry = NULL;
+        }else if(2 == count){
+            roots[d] = NULL;
+            carry = link(sum[0], sum[1]);
+        }else{
+            roots[d] = sum[2];
+            carry = link(sum[0], sum[1]);
+        }
+        update(d);
+    }
+}
+
+//remove the root of the degree, its children are added back
+int ArrayBinomialHeap::removeRoot(int degree)
+{
+    Node *target = roots[degree];
+    int result = target->data;
+    roots[degree] = NULL;
+    update(degree);
+
+    //the child list is in decreasing degree
+    Node *children[64];
+    Node *current = target->child;
+    for(int d=degree-1; d>=0; d--){
+        Node *next = current->sibling;
+        current->parent = NULL;
+        current->sibling = NULL;
+        children[d] = current;
+        current = next;
+    }
+    if(degree > 0){
+        add(children, degree-1);
+    }
+
+    delete target;
+    number--;
+
+    return result;
+}
+
+//insert
+Node *ArrayBinomialHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    Node *newNode = new Node();
+    newNode->data = input;
+
+    add(&newNode, 0);
+    number++;
+
+    return newNode;
+}
+
+//extract_min
+int ArrayBinomialHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(tree[1] < 0)
+        return -1;
+
+    //the children of the min root are added back
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, tree[1]);
+    return removeRoot(tree[1]);
+}
+
+//minimum
+int ArrayBinomialHeap::minimum()
+{
+    if(tree[1] < 0)
+        return -1;
+
+    return roots[tree[1]]->data;
+}
+
+//merge
+void ArrayBinomialHeap::merge(ArrayBinomialHeap &abh)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    add(abh.roots, 63);
+    number += abh.number;
+
+    for(int i=0; i<64; i++){
+        abh.roots[i] = NULL;
+    }
+    for(int i=0; i<128; i++){
+        abh.tree[i] = -1;
+    }
+    abh.number = 0;
+}
+
+//decrease key
+Node *ArrayBinomialHeap::decrease_key(Node *input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NULL == input)
+        return NULL;
+    if(input->data <= new_val)
+        return input;
+
+    input->data = new_val;
+    Node *current = input;
+    Node *parent = current->parent;
+    int levels = 0;
+    while(parent && parent->data > current->data)
+    {
+        //swap
+        int temp = current->data;
+        current->data = parent->data;
+        parent->data = temp;
+
+        //bottom-up
+        current = parent;
+        parent = current->parent;
+        levels++;
+    }
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, levels);
+
+    //a root changed, replay its matches
+    if(NULL == parent){
+        update(current->degree);
+    }
+
+    return current;
+}
+
+//delete
+void ArrayBinomialHeap::delete_key(Node *input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NULL == input)
+        return;
+
+    Node *current = input;
+    Node *parent = current->parent;
+    while(parent)
+    {
+        //swap
+        int temp = current->data;
+        current->data = parent->data;
+        parent->data = temp;
+
+        //bottom-up
+        current = parent;
+        parent = current->parent;
+    }
+
+    removeRoot(current->degree);
+}
+
+//find, preorder without recursion
+Node *ArrayBinomialHeap::find(int key)
+{
+    vector<Node*> stack;
+    for(int d=0; d<64; d++){
+        if(roots[d]) stack.push_back(roots[d]);
+    }
+
+    while(!stack.empty()){
+        Node *current = stack.back();
+        stack.pop_back();
+
+        if(current->data == key)
+            return current;
+
+        for(Node *child=current->child; child; child=child->sibling){
+            stack.push_back(child);
+        }
+    }
+
+    return NULL;
+}
+
+//dump elements
+void ArrayBinomialHeap::dump(void)
+{
+    cout << "Dump the heap : " << endl;
+    for(int d=0; d<64; d++){
+        if(NULL == roots[d])
+            continue;
+
+        cout << "B(" << d << ") =";
+        vector<Node*> stack;
+        stack.push_back(roots[d]);
+        while(!stack.empty()){
+            Node *current = stack.back();
+            stack.pop_back();
+
+            cout << " " << current->data;
+            for(Node *child=current->child; child; child=child->sibling){
+                stack.push_back(child);
+            }
+        }
+        cout << endl;
+    }
+}
+
+//Lazy binomial heap
+//insert and merge only add roots to the list and compare with the
+//cached min node, all tree unions wait for extract_min.
+class LazyBinomialHeap{
+    //core operation
+    Node *link(Node *n1, Node *n2);
+    void addRoot(Node *input);
+    int consolidate(Node *target);
+    int removeMin(void);
+public:
+    Node *minNode=NULL;
+    Node *head=NULL;
+    Node *tail=NULL;
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    LazyBinomialHeap();
+    LazyBinomialHeap(int *arr, int size);
+    Node *insert(int input);
+    int extract_min();
+    int minimum();
+    void merge(LazyBinomialHeap &lbh);
+
+    //decrease-key and delete
+    Node *decrease_key(Node *input, int new_val);
+    void delete_key(Node *input);
+
+    //find
+    Node *find(int key);
+};
+
+LazyBinomialHeap::LazyBinomialHeap()
+{
+
+}
+
+//Initialize
+LazyBinomialHeap::LazyBinomialHeap(int *arr, int size)
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//core operation, must be the same degree
+Node *LazyBinomialHeap::link(Node *n1, Node *n2)
+{
+    Node *less = (n2->data < n1->data)? n2 : n1;
+    Node *greater = (n1 == less)? n2 : n1;
+
+    greater->parent = less;
+    greater->sibling = less->child;
+    less->child = greater;
+    less->degree++;
+
+    return less;
+}
+
+//append a root and keep the min node
+void LazyBinomialHeap::addRoot(Node *input)
+{
+    input->parent = NULL;
+    input->sibling = NULL;
+    if(NULL == head){
+        head = input;
+    }else{
+        tail->sibling = input;
+    }
+    tail = input;
+
+    if(NULL == minNode || input->data < minNode->data){
+        minNode = input;
+    }
+}
+
+//core operation
+//link every root but the target by degree, then rebuild the list,
+//return the number of trees linked
+int LazyBinomialHeap::consolidate(Node *target)
+{
+    int trees = 0;
+    Node *arr[64];
+    for(int i=0; i<64; i++){
+        arr[i] = NULL;
+    }
+
+    //the roots, then the children of the target
+    Node *current = head;
+    bool children = false;
+    while(true){
+        if(NULL == current){
+            if(children)
+                break;
+            children = true;
+            current = target->child;
+            continue;
+        }
+
+        Node *next_node = current->sibling;
+        if(current != target){
+            int degree = current->degree;
+            while(arr[degree]){
+                current = link(arr[degree], current);
+                arr[degree] = NULL;
+                degree++;
+            }
+            arr[degree] = current;
+            trees++;
+        }
+        current = next_node;
+    }
+
+    //reconstruct the root list and find the min node
+    head = tail = minNode = NULL;
+    for(int i=0; i<64; i++){
+        if(arr[i]){
+            addRoot(arr[i]);
+        }
+    }
+
+    return trees;
+}
+
+//core operation, remove the min node, shared by extract_min and delete
+int LazyBinomialHeap::removeMin(void)
+{
+    Node *target = minNode;
+    int result = target->data;
+    int trees = consolidate(target);
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, trees);
+
+    delete target;
+    number--;
+
+    return result;
+}
+
+//insert
+Node *LazyBinomialHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    Node *newNode = new Node();
+    newNode->data = input;
+    addRoot(newNode);
+    number++;
+
+    return newNode;
+}
+
+//extract_min
+int LazyBinomialHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NULL == minNode)
+        return -1;
+
+    return removeMin();
+}
+
+//minimum
+int LazyBinomialHeap::minimum()
+{
+    if(NULL == minNode)
+        return -1;
+
+    return minNode->data;
+}
+
+//merge, concatenate the root lists
+void LazyBinomialHeap::merge(LazyBinomialHeap &lbh)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    if(NULL == lbh.head)
+        return;
+
+    if(NULL == head){
+        head = lbh.head;
+    }else{
+        tail->sibling = lbh.head;
+    }
+    tail = lbh.tail;
+    if(NULL == minNode || lbh.minNode->data < minNode->data){
+        minNode = lbh.minNode;
+    }
+    number += lbh.number;
+
+    lbh.head = lbh.tail = lbh.minNode = NULL;
+    lbh.number = 0;
+}
+
+//decrease key
+Node *LazyBinomialHeap::decrease_key(Node *input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NULL == input)
+        return NULL;
+    if(input->data <= new_val)
+        return input;
+
+    input->data = new_val;
+    Node *current = input;
+    Node *parent = current->parent;
+    int levels = 0;
+    while(parent && parent->data > current->data)
+    {
+        //swap
+        int temp = current->data;
+        current->data = parent->data;
+        parent->data = temp;
+
+        //bottom-up
+        current = parent;
+        parent = current->parent;
+        levels++;
+    }
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, levels);
+
+    if(current->data < minNode->data){
+        minNode = current;
+    }
+
+    return current;
+}
+
+//delete
+void LazyBinomialHeap::delete_key(Node *input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NULL == input)
+        return;
+
+    Node *current = input;
+    Node *parent = current->parent;
+    while(parent)
+    {
+        //swap
+        int temp = current->data;
+        current->data = parent->data;
+        parent->data = temp;
+
+        //bottom-up
+        current = parent;
+        parent = current->parent;
+    }
+
+    //extract min
+    minNode = current;
+    removeMin();
+}
+
+//find, preorder without recursion
+Node *LazyBinomialHeap::find(int key)
+{
+    vector<Node*> stack;
+    for(Node *current=head; current; current=current->sibling){
+        stack.push_back(current);
+    }
+
+    while(!stack.empty()){
+        Node *current = stack.back();
+        stack.pop_back();
+
+        if(current->data == key)
+            return current;
+
+        for(Node *child=current->child; child; child=child->sibling){
+            stack.push_back(child);
+        }
+    }
+
+    return NULL;
+}
+
 /*==============================================================*/
 //Function area
 int *random_case(int base, int number)
@@ -438,7 +1211,7 @@ int *random_case(int base, int number)
     //swap each position
     srand(time(NULL));
     for(int i=0; i<number-1; i++){
-        int j = i + rand() / (RAND_MAX / (number-i));
+        int j = i + rand() % (number-i);
         //swap
         int t=result[i];
         result[i] = result[j];
@@ -511,6 +1284,13 @@ int main(int argc, char const *argv[]){
         cout << "NULL" << endl;
     }
 
+    // Decrease the largest key below the minimum, it becomes the min
+    cout << "\n\tDecrease the largest key to 0" << endl;
+    BinomialHeap minHeap(random_data, SCALE);
+    minHeap.decrease_key(minHeap.find(SCALE), 0);
+    cout << "minimum :" << minHeap.minimum() << endl;
+    cout << "extract_min :" << minHeap.extract_min() << endl;
+
     // Merge the two heap
     cout << "\n\tMerge the two heap" << endl;
     n=13;
@@ -536,6 +1316,135 @@ int main(int argc, char const *argv[]){
     }
     cout << endl;
 
+    // Benchmark bulk construction
+    cout << "\n\tBenchmark bulk construction" << endl;
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    BinomialHeap insertHeap;
+    for(int i=0; i<bench_n; i++){
+        insertHeap.insert(bench_data[i]);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by insert one by one: "
+         << duration.count() << " microseconds" << endl;
+    checksum += insertHeap.extract_min();
+
+    start = high_resolution_clock::now();
+    BinomialHeap bulkHeap(bench_data, bench_n);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by bulk construction: "
+         << duration.count() << " microseconds" << endl;
+    checksum += bulkHeap.extract_min();
+
+    int bench_threads = max(4u, thread::hardware_concurrency());
+    start = high_resolution_clock::now();
+    BinomialHeap parallelHeap(bench_data, bench_n, bench_threads);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by parallel construction, " << bench_threads
+         << " threads: " << duration.count() << " microseconds" << endl;
+    checksum += parallelHeap.extract_min();
+    cout << "checksum :" << checksum << endl;
+
+    // Array-of-roots heap
+    cout << "\n\tArray-of-roots heap" << endl;
+    n = SCALE;
+    ArrayBinomialHeap myArrayHeap(random_data, n);
+    myArrayHeap.dump();
+    cout << "minimum :" << myArrayHeap.minimum() << endl;
+    myArrayHeap.decrease_key(myArrayHeap.find(9), 0);
+    myArrayHeap.delete_key(myArrayHeap.find(5));
+    cout << "decrease-key 9 to 0, delete 5" << endl;
+    ArrayBinomialHeap myArrayHeap2(random_data2, 13);
+    myArrayHeap.merge(myArrayHeap2);
+    myArrayHeap.dump();
+    cout << "Heap sort :";
+    while(myArrayHeap.number){
+        cout << myArrayHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark extract_min
+    cout << "\n\tBenchmark extract_min" << endl;
+    start = high_resolution_clock::now();
+    for(int i=1; i<bench_n; i++){
+        checksum += bulkHeap.extract_min();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by root list extract_min: "
+         << duration.count() << " microseconds" << endl;
+
+    ArrayBinomialHeap arrayHeap(bench_data, bench_n);
+    start = high_resolution_clock::now();
+    for(int i=0; i<bench_n; i++){
+        checksum += arrayHeap.extract_min();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by array-of-roots extract_min: "
+         << duration.count() << " microseconds" << endl;
+    cout << "checksum :" << checksum << endl;
+
+    // Lazy heap
+    cout << "\n\tLazy heap" << endl;
+    LazyBinomialHeap myLazyHeap(random_data, n);
+    cout << "extract_min :" << myLazyHeap.extract_min() << endl;
+    myLazyHeap.decrease_key(myLazyHeap.find(9), 0);
+    myLazyHeap.delete_key(myLazyHeap.find(5));
+    cout << "decrease-key 9 to 0, delete 5" << endl;
+    cout << "Heap sort :";
+    while(myLazyHeap.number){
+        cout << myLazyHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark insert-heavy workload
+    cout << "\n\tBenchmark insert-heavy workload, 16 inserts per extract_min" << endl;
+    {
+        auto start = high_resolution_clock::now();
+        BinomialHeap eagerHeap;
+        for(int i=0; i<bench_n; i++){
+            eagerHeap.insert(bench_data[i]);
+            if(15 == i%16)
+                checksum += eagerHeap.extract_min();
+        }
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by eager heap: "
+             << duration.count() << " microseconds" << endl;
+
+        start = high_resolution_clock::now();
+        ArrayBinomialHeap arrayHeap;
+        for(int i=0; i<bench_n; i++){
+            arrayHeap.insert(bench_data[i]);
+            if(15 == i%16)
+                checksum += arrayHeap.extract_min();
+        }
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by array-of-roots heap: "
+             << duration.count() << " microseconds" << endl;
+
+        start = high_resolution_clock::now();
+        LazyBinomialHeap lazyHeap;
+        for(int i=0; i<bench_n; i++){
+            lazyHeap.insert(bench_data[i]);
+            if(15 == i%16)
+                checksum += lazyHeap.extract_min();
+        }
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by lazy heap: "
+             << duration.count() << " microseconds" << endl;
+    }
+    cout << "checksum :" << checksum << endl;
+
     return 0;
 }
 /*==============================================================*/
\ No newline at end of file
@@ -0,0 +1,359 @@
+/*****************************************************************
+Name    :bitset_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 opt-in operation stats
+    20261019 sparse counts of duplicate keys
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+#include "heap_stats.h"
+#define DEBUG (1)
+#define SCALE (20)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//Priority queue of integer keys in [0, universe)
+//A 64-ary tree of words, bit b of word w on one level is set if word
+//w*64+b on the level below is not zero, level 0 has one bit per key.
+//Every operation walks at most log_64(universe) words with one ctz.
+//The bit of a key on level 0 is its first copy, only the extra copies
+//of duplicate keys are counted, in a hash map, so the space is about
+//universe/8 bytes plus the distinct duplicate keys.
+class BitsetHeap{
+    vector<vector<uint64_t> > level;
+    unordered_map<int, uint32_t> extra;    //copies after the first
+
+    //core operation
+    bool present(int key);
+    void setBit(int key);
+    void clearBit(int key);
+    int descend(int l, int index);
+    void addKey(int key);
+    void removeKey(int key);
+public:
+    int universe;
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    BitsetHeap(int universe);
+    BitsetHeap(int universe, int *arr, int size);
+    int insert(int input);
+    int extract_min();
+    int minimum();
+
+    //decrease-key and delete, the key is the handle
+    int decrease_key(int key, int new_val);
+    void delete_key(int key);
+
+    //the smallest key greater than the key, -1 if none
+    int successor(int key);
+
+    //find, the number of copies of the key
+    int find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+//Initialize, one level per 6 bits of the universe
+BitsetHeap::BitsetHeap(int universe)
+{
+    this->universe = universe;
+
+    int size = universe;
+    do{
+        size = (int)(((long long)size + 63) / 64);
+        level.push_back(vector<uint64_t>(size, 0));
+    }while(size > 1);
+}
+
+BitsetHeap::BitsetHeap(int universe, int *arr, int size) : BitsetHeap(universe)
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//core operation, the key has a copy
+bool BitsetHeap::present(int key)
+{
+    return (level[0][key >> 6] >> (key & 63)) & 1;
+}
+
+//core operation, set the bit and the empty words above it
+void BitsetHeap::setBit(int key)
+{
+    for(int l=0; l<(int)level.size(); l++){
+        uint64_t &word = level[l][key >> 6];
+        bool was_empty = (0 == word);
+        word |= (uint64_t)1 << (key & 63);
+        if(!was_empty)
+            break;
+        key >>= 6;
+    }
+}
+
+//core operation, clear the bit and the words above that become empty
+void BitsetHeap::clearBit(int key)
+{
+    for(int l=0; l<(int)level.size(); l++){
+        uint64_t &word = level[l][key >> 6];
+        word &= ~((uint64_t)1 << (key & 63));
+        if(0 != word)
+            break;
+        key >>= 6;
+    }
+}
+
+//the first key under the set bit index of level l
+int BitsetHeap::descend(int l, int index)
+{
+    for(l--; l>=0; l--){
+        index = (index << 6) + __builtin_ctzll(level[l][index]);
+    }
+
+    return index;
+}
+
+//one more copy of the key
+void BitsetHeap::addKey(int key)
+{
+    if(present(key)){
+        extra[key]++;
+    }else{
+        setBit(key);
+    }
+    number++;
+}
+
+//one copy less of a key that is present
+void BitsetHeap::removeKey(int key)
+{
+    auto it = extra.find(key);
+    if(it == extra.end()){
+        clearBit(key);
+    }else if(0 == --it->second){
+        extra.erase(it);
+    }
+    number--;
+}
+
+//insert, return the key as the handle, -1 if out of the universe
+int BitsetHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    if(input < 0 || input >= universe)
+        return -1;
+
+    addKey(input);
+
+    return input;
+}
+
+//extract min
+int BitsetHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(0 == number)
+        return -1;
+
+    int result = minimum();
+    removeKey(result);
+
+    return result;
+}
+
+//minimum, from the top word down
+int BitsetHeap::minimum()
+{
+    if(0 == number)
+        return -1;
+
+    int top = level.size() - 1;
+    return descend(top+1, 0);
+}
+
+//decrease key, one copy of the key moves to the new value
+int BitsetHeap::decrease_key(int key, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(key < 0 || key >= universe || !present(key) || new_val < 0)
+        return -1;
+    if(key <= new_val)
+        return key;
+
+    removeKey(key);
+    addKey(new_val);
+
+    return new_val;
+}
+
+//delete one copy of the key
+void BitsetHeap::delete_key(int key)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(key < 0 || key >= universe || !present(key))
+        return;
+
+    removeKey(key);
+}
+
+//successor, go up until a word has a set bit after the position,
+//then down along the lowest set bits
+int BitsetHeap::successor(int key)
+{
+    int index = key + 1;
+    if(index < 0 || index >= universe)
+        return -1;
+
+    for(int l=0; l<(int)level.size(); l++){
+        int w = index >> 6;
+        if(w >= (int)level[l].size())
+            return -1;
+
+        uint64_t word = level[l][w] & (~(uint64_t)0 << (index & 63));
+        if(word){
+            return descend(l, (w << 6) + __builtin_ctzll(word));
+        }
+        index = w + 1;
+    }
+
+    return -1;
+}
+
+//find
+int BitsetHeap::find(int key)
+{
+    if(key < 0 || key >= universe || !present(key))
+        return 0;
+
+    auto it = extra.find(key);
+    return 1 + (it == extra.end() ? 0 : it->second);
+}
+
+//dump elements, key(count)
+void BitsetHeap::dump(void)
+{
+    cout << "Dump the heap :";
+    int key = (0 == number) ? -1 : minimum();
+    while(key >= 0){
+        cout << " " << key;
+        if(find(key) > 1){
+            cout << "(" << find(key) << ")";
+        }
+        key = successor(key);
+    }
+    cout << endl;
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Initialize from the array
+    cout << "\n\tInitialize from the array" << endl;
+    BitsetHeap myHeap(1<<16, random_data, n);
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Insert the new element
+    cout << "\n\tInsert the new element" << endl;
+    myHeap.insert(8);
+    myHeap.insert(15);
+    myHeap.insert(4000);
+    myHeap.dump();
+
+    // Test minimum and extract min
+    cout << "\n\tTest minimum and extract min" << endl;
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "successor of 20 :" << myHeap.successor(20) << endl;
+
+    // Test decrease-key and delete
+    cout << "\n\tTest decrease-key and delete" << endl;
+    cout << "decrease-key from 4000 to "
+         << myHeap.decrease_key(4000, 3) << endl;
+    myHeap.delete_key(8);
+    myHeap.delete_key(6);
+    cout << "delete 8 and 6" << endl;
+    myHeap.dump();
+    cout << "find 8 :" << myHeap.find(8) << endl;
+
+    // Heap sort
+    cout << "\n\tHeap sort" << endl;
+    cout << "Heap sort :";
+    while(myHeap.number){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark hold model, 24-bit keys
+    cout << "\n\tBenchmark hold model, 24-bit keys" << endl;
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(0, 1<<24);
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    BitsetHeap benchHeap(1<<24, bench_data, bench_n);
+    for(int i=0; i<bench_n; i++){
+        checksum += benchHeap.extract_min();
+        benchHeap.insert(bench_data[(bench_n + i) % (1<<24)]);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by extract_min and insert: "
+         << duration.count() << " microseconds" << endl;
+    cout << "checksum :" << checksum << endl;
+
+    return 0;
+}
+/*==============================================================*/
@@ -3,6 +3,15 @@ Name    :fibonacci_heap
 Author  :srhuang
 Email   :lukyandy3162@gmail.com
 History :
+    20261019 delete does not count an extract_min too
+    20261019 stats for the compact heap
+    20261019 keep the number when merging into an empty heap
+    20261019 opt-in operation stats
+    20261019 batched decrease-key
+    20261019 optional hash index for find
+    20261019 fix the degree bound in consolidate
+    20261019 O(n) lazy bulk construction
+    20261019 compact heap with arena nodes and 32-bit indices
     20200302 complete all seven functions
     20200222 consolidate and extract_min
     20200114 Initial Version
@@ -11,8 +20,15 @@ History :
 #include <vector>
 #include <queue>
 #include <cmath>
+#include <chrono>
+#include <cstdint>
+#include "key_index.h"
+#include "heap_stats.h"
 #define DEBUG (1)
 #define SCALE (20)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
 using namespace std;
 using namespace std::chrono;
 
@@ -37,15 +53,27 @@ private:
     //core operation
     Node *treeUnion(Node *n1, Node *n2); //must be the same degree
     void consolidate(void); //handle with tree union
+    int removeMin(void);
 
     //levelorder traversal
     void levelorderTraversal(Node *current);
 
     //preorder find
     Node *levelorderFind(Node *current, int key);
+
+    //add every node of the root list into the index
+    void indexRootList(Node *start);
 public:
     Node *minNode=NULL;
     int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //optional key -> node index
+    bool indexed=false;
+    KeyIndex<Node> index;
+    void enable_index(void);
 
     //five operations
     FibonacciHeap();
@@ -57,10 +85,11 @@ public:
 
     //cut and cascade cut
     void cut(Node *current, Node *parent);
-    void cascade_cut(Node *current);
+    int cascade_cut(Node *current);
 
     //decrease-key and delete
     Node *decrease_key(Node *input, int new_val);
+    void decrease_keys(Node **input, int *new_val, int count);
     void delete_key(Node *input);
 
     //find
@@ -117,7 +146,9 @@ Node *FibonacciHeap::treeUnion(Node *n1, Node *n2)
 //core operation
 void FibonacciHeap::consolidate(void)
 {
-    int max_degree = log(number) / log(2);
+    //cut and cascade cut can push the degree over log2(number),
+    //the bound is log_phi(number) < 64
+    const int max_degree = 63;
     Node* arr[max_degree+1];
 
     //initialize the arr
@@ -125,6 +156,16 @@ void FibonacciHeap::consolidate(void)
         arr[i] = NULL;
     }
 
+#ifdef HEAP_STATS
+    int roots = 0;
+    Node *root = minNode;
+    do{
+        roots++;
+        root = root->right;
+    }while(root != minNode);
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, roots);
+#endif
+
     //trace each node in the root list, from min back to min circularly.
     Node *current = minNode;
     Node *next_node;
@@ -186,17 +227,40 @@ void FibonacciHeap::consolidate(void)
 }
 
 //Initialize
+//splice n singleton roots in O(n), the first extract_min consolidates
 FibonacciHeap::FibonacciHeap(int *arr, int size)
 {
-    for(int i=0; i<size; i++){
-        insert(arr[i]);
-        consolidate();
+    if(size <= 0)
+        return;
+
+    Node *first = new Node();
+    first->data = arr[0];
+    first->left = first;
+    first->right = first;
+    minNode = first;
+
+    Node *last = first;
+    for(int i=1; i<size; i++){
+        Node *newNode = new Node();
+        newNode->data = arr[i];
+        newNode->left = last;
+        last->right = newNode;
+        last = newNode;
+
+        if(newNode->data < minNode->data){
+            minNode = newNode;
+        }
     }
+    last->right = first;
+    first->left = last;
+
+    number = size;
 }
 
 //insert
 Node *FibonacciHeap::insert(int input)
 {
+    HEAP_STATS_OP(STATS_INSERT);
     Node *newNode = new Node();
     newNode->data = input;
 
@@ -229,15 +293,15 @@ Node *FibonacciHeap::insert(int input)
     //add the number of heap
     number++;
 
+    if(indexed)
+        index.insert(input, newNode);
+
     return newNode;
 }
 
-//extract_min
-int FibonacciHeap::extract_min()
+//core operation, remove the min node, shared by extract_min and delete
+int FibonacciHeap::removeMin(void)
 {
-    if(NULL==minNode)
-        return -1;
-
     int result = minNode->data;
 
     if(minNode->child != NULL){
@@ -271,6 +335,8 @@ int FibonacciHeap::extract_min()
     }
     
     //delete the min Node
+    if(indexed)
+        index.erase(result, target);
     delete target;
     target = NULL;
     number--;
@@ -278,6 +344,16 @@ int FibonacciHeap::extract_min()
     return result;
 }
 
+//extract_min
+int FibonacciHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NULL==minNode)
+        return -1;
+
+    return removeMin();
+}
+
 //minimum
 int FibonacciHeap::minimum()
 {
@@ -290,8 +366,12 @@ int FibonacciHeap::minimum()
 //merge
 void FibonacciHeap::merge(FibonacciHeap &fh)
 {
+    HEAP_STATS_OP(STATS_MERGE);
     if(NULL == minNode){
         minNode = fh.minNode;
+        number = fh.number;
+        if(indexed && minNode)
+            indexRootList(minNode);
         return;
     }
 
@@ -299,6 +379,9 @@ void FibonacciHeap::merge(FibonacciHeap &fh)
         return;
     }
 
+    if(indexed)
+        indexRootList(fh.minNode);
+
     //concatenate
     fh.minNode->left->right = minNode;
     Node *temp = fh.minNode->left;
@@ -345,7 +428,8 @@ void FibonacciHeap::cut(Node *current, Node *parent)
     current->mark = false;
 }
 
-void FibonacciHeap::cascade_cut(Node *current)
+//return how many ancestors were cut
+int FibonacciHeap::cascade_cut(Node *current)
 {
     Node *parent = current->parent;
     if(parent != NULL){
@@ -353,25 +437,34 @@ void FibonacciHeap::cascade_cut(Node *current)
             current->mark=true;
         }else{
             cut(current, parent);
-            cascade_cut(parent);
+            return 1 + cascade_cut(parent);
         }
     }
+
+    return 0;
 }
 
 //decrease key
 Node *FibonacciHeap::decrease_key(Node *input, int new_val)
 {
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
     if(NULL == input)
         return NULL;
     if(input->data <= new_val)
         return input;
 
+    if(indexed){
+        index.erase(input->data, input);
+        index.insert(new_val, input);
+    }
+
     input->data = new_val;
     Node *current = input;
     Node *parent = current->parent;
     if(parent != NULL && current->data < parent->data){
         cut(current, parent);
-        cascade_cut(parent);
+        int chain = cascade_cut(parent);
+        HEAP_STATS_RECORD(STATS_CASCADE_CUT, chain);
     }
 
     //check the min node
@@ -382,9 +475,48 @@ Node *FibonacciHeap::decrease_key(Node *input, int new_val)
     return current;
 }
 
+//batched decrease key
+//all the cuts first, then one pass for the min node over the touched
+//nodes that ended up in the root list. A touched node that still has a
+//parent after its own turn was not cut, so its key is no less than the
+//parent's, and parents only get smaller later. Every node that is not a
+//root has a root above it that is no greater, so only the roots can be
+//the new min, and the roots that were not touched are no less than the
+//old min.
+void FibonacciHeap::decrease_keys(Node **input, int *new_val, int count)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    for(int i=0; i<count; i++){
+        Node *current = input[i];
+        if(NULL == current || current->data <= new_val[i])
+            continue;
+
+        if(indexed){
+            index.erase(current->data, current);
+            index.insert(new_val[i], current);
+        }
+
+        current->data = new_val[i];
+        Node *parent = current->parent;
+        if(parent != NULL && current->data < parent->data){
+            cut(current, parent);
+            int chain = cascade_cut(parent);
+            HEAP_STATS_RECORD(STATS_CASCADE_CUT, chain);
+        }
+    }
+
+    for(int i=0; i<count; i++){
+        Node *current = input[i];
+        if(current && NULL == current->parent && current->data < minNode->data){
+            minNode = current;
+        }
+    }
+}
+
 //delete
 void FibonacciHeap::delete_key(Node *input)
 {
+    HEAP_STATS_OP(STATS_DELETE);
     if(NULL == input)
         return;
 
@@ -392,6 +524,12 @@ void FibonacciHeap::delete_key(Node *input)
     Node *parent = current->parent;
     while(parent)
     {
+        //the keys change nodes
+        if(indexed){
+            index.relink(current->data, current, parent);
+            index.relink(parent->data, parent, current);
+        }
+
         //swap
         int temp = current->data;
         current->data = parent->data;
@@ -404,7 +542,39 @@ void FibonacciHeap::delete_key(Node *input)
 
     //extract min
     minNode = current;
-    extract_min();
+    removeMin();
+}
+
+//levelorder over the root list and all the child lists
+void FibonacciHeap::indexRootList(Node *start)
+{
+    queue<Node*> q;
+    q.push(start);
+
+    while(!q.empty()){
+        Node *temp = q.front();
+        q.pop();
+
+        Node *terminal = temp;
+        do{
+            index.insert(temp->data, temp);
+            if(temp->child)
+                q.push(temp->child);
+            temp = temp->right;
+        }while(temp != terminal);
+    }
+}
+
+//build the index of the current nodes, kept up to date from now on
+void FibonacciHeap::enable_index(void)
+{
+    if(indexed)
+        return;
+
+    indexed = true;
+    index.clear();
+    if(minNode)
+        indexRootList(minNode);
 }
 
 Node *FibonacciHeap::levelorderFind(Node *current, int key)
@@ -437,6 +607,9 @@ Node *FibonacciHeap::levelorderFind(Node *current, int key)
 //find
 Node *FibonacciHeap::find(int key)
 {
+    if(indexed)
+        return index.find(key);
+
     if(NULL == minNode)
         return NULL;
 
@@ -447,6 +620,7 @@ Node *FibonacciHeap::find(int key)
         
         if(current->data == key){
             result = current;
+            break;
         }else{
             result = levelorderFind(current, key);
             if(result != NULL)
@@ -504,6 +678,431 @@ void FibonacciHeap::dump(void)
     }while(current!=minNode);
 }
 
+//Compact node, 32-bit indices into the arena instead of pointers
+//24 bytes instead of 48 bytes for Node
+#define NIL (0xFFFFFFFFu)
+struct CompactNode{
+    int data;
+    uint32_t parent;
+    uint32_t child;
+    uint32_t left;
+    uint32_t right;     //next free node when released
+    uint16_t degree;
+    bool mark;
+};
+
+//Fibonacci heap on an arena of compact nodes
+//released nodes are recycled through the free list, the handle is the
+//index of the node in the arena.
+class CompactFibonacciHeap{
+private:
+    //arena
+    uint32_t allocate(int input);
+    void release(uint32_t index);
+
+    //core operation
+    void link(uint32_t less, uint32_t greater);
+    void consolidate(void);
+    void addRoot(uint32_t index);
+    int removeMin(void);
+public:
+    vector<CompactNode> pool;
+    uint32_t free_list=NIL;
+    uint32_t minNode=NIL;
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    CompactFibonacciHeap();
+    CompactFibonacciHeap(int *arr, int size);
+    uint32_t insert(int input);
+    int extract_min();
+    int minimum();
+    uint32_t merge(CompactFibonacciHeap &fh);
+
+    //cut and cascade cut
+    void cut(uint32_t current, uint32_t parent);
+    int cascade_cut(uint32_t current);
+
+    //decrease-key and delete
+    uint32_t decrease_key(uint32_t input, int new_val);
+    void delete_key(uint32_t input);
+
+    //drop every node at once
+    void clear(void);
+
+    //dump elements
+    void dump(void);
+};
+
+CompactFibonacciHeap::CompactFibonacciHeap()
+{
+
+}
+
+//arena
+uint32_t CompactFibonacciHeap::allocate(int input)
+{
+    uint32_t index;
+    if(free_list != NIL){
+        index = free_list;
+        free_list = pool[index].right;
+    }else{
+        index = pool.size();
+        pool.push_back(CompactNode());
+    }
+
+    CompactNode &node = pool[index];
+    node.data = input;
+    node.parent = NIL;
+    node.child = NIL;
+    node.left = index;
+    node.right = index;
+    node.degree = 0;
+    node.mark = false;
+
+    return index;
+}
+
+void CompactFibonacciHeap::release(uint32_t index)
+{
+    pool[index].right = free_list;
+    free_list = index;
+}
+
+//add a single node to the left of the min node
+void CompactFibonacciHeap::addRoot(uint32_t index)
+{
+    CompactNode &node = pool[index];
+    node.parent = NIL;
+    if(NIL == minNode){
+        node.left = index;
+        node.right = index;
+        minNode = index;
+        return;
+    }
+
+    CompactNode &min = pool[minNode];
+    node.right = minNode;
+    node.left = min.left;
+    pool[min.left].right = index;
+    min.left = index;
+    if(node.data < min.data){
+        minNode = index;
+    }
+}
+
+//core operation, the greater root becomes a child of the less one
+void CompactFibonacciHeap::link(uint32_t less, uint32_t greater)
+{
+    CompactNode &l = pool[less];
+    CompactNode &g = pool[greater];
+
+    g.parent = less;
+    g.mark = false;
+    if(NIL == l.child){
+        g.left = greater;
+        g.right = greater;
+        l.child = greater;
+    }else{
+        CompactNode &c = pool[l.child];
+        g.right = l.child;
+        g.left = c.left;
+        pool[c.left].right = greater;
+        c.left = greater;
+    }
+    l.degree++;
+}
+
+//core operation
+void CompactFibonacciHeap::consolidate(void)
+{
+    //degree is below log_phi(2^32) < 64
+    uint32_t arr[64];
+    for(int i=0; i<64; i++){
+        arr[i] = NIL;
+    }
+
+    //the right of every unvisited root is untouched by link()
+    int roots = 0;
+    uint32_t start = minNode;
+    uint32_t current = minNode;
+    do{
+        uint32_t next_node = pool[current].right;
+        roots++;
+
+        int temp_degree = pool[current].degree;
+        while(arr[temp_degree] != NIL){
+            uint32_t other = arr[temp_degree];
+            if(pool[other].data < pool[current].data){
+                uint32_t temp = other;
+                other = current;
+                current = temp;
+            }
+            link(current, other);
+            arr[temp_degree] = NIL;
+            temp_degree++;
+        }
+        arr[temp_degree] = current;
+
+        current = next_node;
+    }while(current != start);
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, roots);
+
+    //reconstruct the root list and find the min node
+    minNode = NIL;
+    for(int i=0; i<64; i++){
+        if(arr[i] != NIL){
+            addRoot(arr[i]);
+        }
+    }
+}
+
+//Initialize
+CompactFibonacciHeap::CompactFibonacciHeap(int *arr, int size)
+{
+    pool.reserve(size);
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//insert
+uint32_t CompactFibonacciHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    uint32_t index = allocate(input);
+    addRoot(index);
+    number++;
+
+    return index;
+}
+
+//core operation, remove the min node, shared by extract_min and delete
+int CompactFibonacciHeap::removeMin(void)
+{
+    uint32_t target = minNode;
+    int result = pool[target].data;
+
+    //move the children into the root list
+    uint32_t current = pool[target].child;
+    if(current != NIL){
+        do{
+            uint32_t next_node = pool[current].right;
+            addRoot(current);
+            current = next_node;
+        }while(pool[current].parent == target);
+    }
+
+    //remove the min node from the root list
+    if(pool[target].right == target){
+        minNode = NIL;
+    }else{
+        pool[pool[target].left].right = pool[target].right;
+        pool[pool[target].right].left = pool[target].left;
+        minNode = pool[target].right;
+        consolidate();
+    }
+
+    release(target);
+    number--;
+
+    return result;
+}
+
+//extract_min
+int CompactFibonacciHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NIL == minNode)
+        return -1;
+
+    return removeMin();
+}
+
+//minimum
+int CompactFibonacciHeap::minimum()
+{
+    if(NIL == minNode)
+        return -1;
+
+    return pool[minNode].data;
+}
+
+//merge, the nodes of fh are moved into this arena
+//return the offset to add to the handles of fh
+uint32_t CompactFibonacciHeap::merge(CompactFibonacciHeap &fh)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    uint32_t offset = pool.size();
+    if(NIL == fh.minNode)
+        return offset;
+
+    //relocate the arena of fh
+    pool.insert(pool.end(), fh.pool.begin(), fh.pool.end());
+    for(uint32_t i=offset; i<pool.size(); i++){
+        CompactNode &node = pool[i];
+        if(node.parent != NIL) node.parent += offset;
+        if(node.child != NIL) node.child += offset;
+        node.left += offset;
+        if(node.right != NIL) node.right += offset;
+    }
+
+    //chain the free list of fh after ours
+    uint32_t fh_free = fh.free_list;
+    while(fh_free != NIL){
+        uint32_t next_free = fh.pool[fh_free].right;
+        release(fh_free + offset);
+        fh_free = next_free;
+    }
+
+    //concatenate the root lists
+    uint32_t fh_min = fh.minNode + offset;
+    if(NIL == minNode){
+        minNode = fh_min;
+    }else{
+        uint32_t fh_last = pool[fh_min].left;
+        pool[fh_last].right = minNode;
+        pool[fh_min].left = pool[minNode].left;
+        pool[pool[minNode].left].right = fh_min;
+        pool[minNode].left = fh_last;
+        if(pool[fh_min].data < pool[minNode].data){
+            minNode = fh_min;
+        }
+    }
+    number += fh.number;
+    fh.clear();
+
+    return offset;
+}
+
+//Cutting a node in the heap to be placed in the root list
+void CompactFibonacciHeap::cut(uint32_t current, uint32_t parent)
+{
+    CompactNode &c = pool[current];
+    CompactNode &p = pool[parent];
+
+    if(c.right == current){
+        p.child = NIL;
+    }else{
+        if(p.child == current){
+            p.child = c.right;
+        }
+        pool[c.left].right = c.right;
+        pool[c.right].left = c.left;
+    }
+    p.degree--;
+
+    c.mark = false;
+    addRoot(current);
+}
+
+//return the number of ancestors cut
+int CompactFibonacciHeap::cascade_cut(uint32_t current)
+{
+    int chain = 0;
+    uint32_t parent = pool[current].parent;
+    while(parent != NIL){
+        if(!pool[current].mark){
+            pool[current].mark = true;
+            break;
+        }
+        cut(current, parent);
+        chain++;
+        current = parent;
+        parent = pool[current].parent;
+    }
+
+    return chain;
+}
+
+//decrease key
+uint32_t CompactFibonacciHeap::decrease_key(uint32_t input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NIL == input)
+        return NIL;
+    if(pool[input].data <= new_val)
+        return input;
+
+    pool[input].data = new_val;
+    uint32_t parent = pool[input].parent;
+    if(parent != NIL && new_val < pool[parent].data){
+        cut(input, parent);
+        int chain = cascade_cut(parent);
+        HEAP_STATS_RECORD(STATS_CASCADE_CUT, chain);
+    }
+
+    //check the min node
+    if(new_val < pool[minNode].data){
+        minNode = input;
+    }
+
+    return input;
+}
+
+//delete, cut the node into the root list and extract it as the min
+//so the other handles keep their keys
+void CompactFibonacciHeap::delete_key(uint32_t input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NIL == input)
+        return;
+
+    uint32_t parent = pool[input].parent;
+    if(parent != NIL){
+        cut(input, parent);
+        cascade_cut(parent);
+    }
+
+    minNode = input;
+    removeMin();
+}
+
+//drop every node at once
+void CompactFibonacciHeap::clear(void)
+{
+    pool.clear();
+    free_list = NIL;
+    minNode = NIL;
+    number = 0;
+}
+
+//dump elements
+void CompactFibonacciHeap::dump(void)
+{
+    if(NIL == minNode)
+        return;
+
+    cout << "Dump the heap : " << endl;
+    uint32_t current = minNode;
+    do{
+        cout << "B(" << pool[current].degree << ") = " << pool[current].data;
+
+        //levelorder traversal
+        queue<uint32_t> q;
+        if(pool[current].child != NIL)  q.push(pool[current].child);
+        while(!q.empty()){
+            uint32_t temp = q.front();
+            q.pop();
+
+            uint32_t terminal = temp;
+            cout << "(";
+            do{
+                cout << " " << pool[temp].data;
+                if(pool[temp].child != NIL)  q.push(pool[temp].child);
+                temp = pool[temp].right;
+            }while(temp != terminal);
+            cout << ")";
+        }
+        cout << endl;
+
+        current = pool[current].right;
+    }while(current != minNode);
+}
+
 /*==============================================================*/
 //Function area
 int *random_case(int base, int number)
@@ -518,7 +1117,7 @@ int *random_case(int base, int number)
     //swap each position
     srand(time(NULL));
     for(int i=0; i<number-1; i++){
-        int j = i + rand() / (RAND_MAX / (number-i));
+        int j = i + rand() % (number-i);
         //swap
         int t=result[i];
         result[i] = result[j];
@@ -594,6 +1193,23 @@ int main(int argc, char const *argv[]){
         cout << "NULL" << endl;
     }
 
+    // Find every key, all of them are roots before the first extract_min
+    cout << "\n\tFind every key of a new heap" << endl;
+    FibonacciHeap rootHeap(random_data, SCALE);
+    int found = 0;
+    for(int key=1; key<=SCALE; key++){
+        if(rootHeap.find(key) && rootHeap.find(key)->data == key)
+            found++;
+    }
+    cout << "found without the index :" << found;
+    rootHeap.enable_index();
+    found = 0;
+    for(int key=1; key<=SCALE; key++){
+        if(rootHeap.find(key) && rootHeap.find(key)->data == key)
+            found++;
+    }
+    cout << ", with the index :" << found << " of " << SCALE << endl;
+
     // Merge the two heap
     cout << "\n\tMerge the two heap" << endl;
     n=13;
@@ -620,6 +1236,130 @@ int main(int argc, char const *argv[]){
     }
     cout << endl;
 
+    // Compact heap on an arena
+    cout << "\n\tCompact heap on an arena" << endl;
+    n = SCALE;
+    CompactFibonacciHeap myCompactHeap(random_data, n);
+    uint32_t handle = myCompactHeap.insert(8);
+    cout << "extract_min :" << myCompactHeap.extract_min() << endl;
+    myCompactHeap.dump();
+    myCompactHeap.decrease_key(handle, 0);
+    cout << "decrease-key 8 to 0" << endl;
+    myCompactHeap.delete_key(5);
+    cout << "delete handle 5" << endl;
+    CompactFibonacciHeap myCompactHeap2(random_data2, 13);
+    myCompactHeap.merge(myCompactHeap2);
+    cout << "Heap sort :";
+    while(myCompactHeap.number){
+        cout << myCompactHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark node memory and allocation
+    cout << "\n\tBenchmark node memory and allocation" << endl;
+    cout << "sizeof(Node) :" << sizeof(Node)
+         << ", sizeof(CompactNode) :" << sizeof(CompactNode) << endl;
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    FibonacciHeap benchHeap;
+    for(int i=0; i<bench_n; i++){
+        benchHeap.insert(bench_data[i]);
+    }
+    for(int i=0; i<bench_n; i++){
+        checksum += benchHeap.extract_min();
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by Node insert/extract_min: "
+         << duration.count() << " microseconds" << endl;
+
+    start = high_resolution_clock::now();
+    CompactFibonacciHeap benchCompactHeap;
+    for(int i=0; i<bench_n; i++){
+        benchCompactHeap.insert(bench_data[i]);
+    }
+    for(int i=0; i<bench_n; i++){
+        checksum += benchCompactHeap.extract_min();
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by CompactNode insert/extract_min: "
+         << duration.count() << " microseconds" << endl;
+
+    //teardown of a full heap
+    for(int i=0; i<bench_n; i++){
+        benchCompactHeap.insert(bench_data[i]);
+    }
+    benchCompactHeap.extract_min();
+    start = high_resolution_clock::now();
+    benchCompactHeap.clear();
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by CompactNode clear of " << bench_n << " nodes: "
+         << duration.count() << " microseconds" << endl;
+    // Benchmark bulk construction
+    cout << "\n\tBenchmark bulk construction" << endl;
+    start = high_resolution_clock::now();
+    FibonacciHeap bulkHeap(bench_data, bench_n);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by bulk construction: "
+         << duration.count() << " microseconds" << endl;
+
+    start = high_resolution_clock::now();
+    checksum += bulkHeap.extract_min();
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by the first extract_min: "
+         << duration.count() << " microseconds" << endl;
+    cout << "checksum :" << checksum << endl;
+
+    // Benchmark batched decrease-key
+    cout << "\n\tBenchmark batched decrease-key" << endl;
+    int batch = bench_n / 10;
+    FibonacciHeap loopHeap, batchHeap;
+    Node **loop_handle = new Node*[bench_n];
+    Node **batch_handle = new Node*[bench_n];
+    for(int i=0; i<bench_n; i++){
+        loop_handle[i] = loopHeap.insert(bench_data[i]);
+        batch_handle[i] = batchHeap.insert(bench_data[i]);
+    }
+    //one extract_min of a sentinel builds the trees
+    loopHeap.insert(0);
+    loopHeap.extract_min();
+    batchHeap.insert(0);
+    batchHeap.extract_min();
+
+    Node **batch_node = new Node*[batch];
+    int *batch_val = new int[batch];
+    for(int i=0; i<batch; i++){
+        batch_node[i] = batch_handle[bench_data[i] - 1];
+        batch_val[i] = -bench_data[i];
+    }
+    checksum = 0;
+
+    start = high_resolution_clock::now();
+    for(int i=0; i<batch; i++){
+        loopHeap.decrease_key(loop_handle[bench_data[i] - 1], batch_val[i]);
+    }
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << batch << " decrease_key: "
+         << duration.count() << " microseconds" << endl;
+    checksum += loopHeap.extract_min();
+
+    start = high_resolution_clock::now();
+    batchHeap.decrease_keys(batch_node, batch_val, batch);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by decrease_keys of " << batch << ": "
+         << duration.count() << " microseconds" << endl;
+    checksum += batchHeap.extract_min();
+    cout << "checksum :" << checksum << endl;
+
     return 0;
 }
 /*==============================================================*/
\ No newline at end of file
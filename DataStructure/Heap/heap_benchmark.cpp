@@ -0,0 +1,391 @@
+/*****************************************************************
+Name    :heap_benchmark
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 stats of every heap on the traces
+    20261019 operation stats with -DHEAP_STATS
+    20261019 hold model with bounded integer keys, bitset heap
+    20261019 Dijkstra trace, radix heap
+    20261019 find with and without the hash index
+    20261019 Initial Version, decrease-key heavy workload
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "key_index.h"
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (200000)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//Every heap file is a standalone program with its own Node and main(),
+//so each one is pulled in inside its own namespace with main() renamed.
+//The standard headers and the shared heap headers they use must be
+//included above, so there is one copy of them in the global namespace.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main binomial_heap_main
+namespace binomial{
+#include "binomial_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main leftist_heap_main
+namespace leftist{
+#include "leftist_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main fibonacci_heap_main
+namespace fibonacci{
+#include "fibonacci_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main pairing_heap_main
+namespace pairing{
+#include "pairing_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main rank_pairing_heap_main
+namespace rank_pairing{
+#include "rank_pairing_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main radix_heap_main
+namespace radix{
+#include "radix_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main bitset_heap_main
+namespace bitset{
+#include "bitset_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+//operation trace, the ids of the elements are dense from 0
+enum TraceType{
+    TRACE_INSERT,
+    TRACE_DECREASE,
+    TRACE_EXTRACT
+};
+
+struct TraceOp{
+    TraceType type;
+    int id;
+    int key;
+};
+
+/*==============================================================*/
+//Function area
+//n inserts, then ops steps of which 4 in 5 decrease a random live key
+//and 1 in 5 extracts the min, then drain the heap.
+//Keys are kept distinct so every heap extracts the same ids.
+vector<TraceOp> decrease_key_heavy_trace(int n, int ops)
+{
+    vector<TraceOp> trace;
+    map<int, int> keys;         //key -> id
+    vector<int> key_of(n);
+    vector<int> live;           //live ids
+    vector<int> live_pos(n);
+
+    srand(2026);
+    for(int id=0; id<n; id++){
+        int key;
+        do{
+            key = rand() % (1<<30);
+        }while(keys.count(key));
+
+        keys[key] = id;
+        key_of[id] = key;
+        live_pos[id] = live.size();
+        live.push_back(id);
+        trace.push_back({TRACE_INSERT, id, key});
+    }
+
+    for(int i=0; i<ops && !live.empty(); i++){
+        if(rand() % 5){
+            int id = live[rand() % live.size()];
+            int key;
+            do{
+                key = key_of[id] - 1 - rand() % (1<<20);
+            }while(keys.count(key));
+
+            keys.erase(key_of[id]);
+            keys[key] = id;
+            key_of[id] = key;
+            trace.push_back({TRACE_DECREASE, id, key});
+        }else{
+            int id = keys.begin()->second;
+            keys.erase(keys.begin());
+
+            //remove from the live ids
+            live[live_pos[id]] = live.back();
+            live_pos[live.back()] = live_pos[id];
+            live.pop_back();
+            trace.push_back({TRACE_EXTRACT, id, key_of[id]});
+        }
+    }
+
+    for(int i=0; i<(int)live.size(); i++){
+        trace.push_back({TRACE_EXTRACT, -1, 0});
+    }
+
+    return trace;
+}
+
+//Dijkstra from vertex 0 on a random graph, every vertex has degree
+//out-edges with weights in 1..1000. The ids are the vertices and the
+//extracted keys never decrease, so the monotone heaps can replay it.
+vector<TraceOp> dijkstra_trace(int n, int degree)
+{
+    vector<TraceOp> trace;
+    vector<vector<pair<int, int> > > adj(n);     //(vertex, weight)
+    vector<int> dist(n, INT_MAX);
+    vector<bool> done(n, false);
+    set<pair<int, int> > queue;                 //(dist, vertex)
+
+    srand(2026);
+    for(int u=0; u<n; u++){
+        for(int k=0; k<degree; k++){
+            adj[u].push_back(make_pair(rand() % n, 1 + rand() % 1000));
+        }
+    }
+
+    dist[0] = 0;
+    queue.insert(make_pair(0, 0));
+    trace.push_back({TRACE_INSERT, 0, 0});
+    while(!queue.empty()){
+        int u = queue.begin()->second;
+        queue.erase(queue.begin());
+        done[u] = true;
+        trace.push_back({TRACE_EXTRACT, u, dist[u]});
+
+        for(int k=0; k<(int)adj[u].size(); k++){
+            int v = adj[u][k].first;
+            int d = dist[u] + adj[u][k].second;
+            if(done[v] || d >= dist[v])
+                continue;
+
+            if(INT_MAX == dist[v]){
+                trace.push_back({TRACE_INSERT, v, d});
+            }else{
+                queue.erase(make_pair(dist[v], v));
+                trace.push_back({TRACE_DECREASE, v, d});
+            }
+            dist[v] = d;
+            queue.insert(make_pair(d, v));
+        }
+    }
+
+    return trace;
+}
+
+//replay the trace, the handle of every id is kept for decrease_key
+template<class Heap>
+long long replay(Heap &heap, vector<TraceOp> &trace, int n)
+{
+    typedef decltype(heap.insert(0)) Handle;
+    vector<Handle> handles(n);
+    long long checksum = 0;
+
+    for(int i=0; i<(int)trace.size(); i++){
+        TraceOp &op = trace[i];
+        switch(op.type){
+        case TRACE_INSERT:
+            handles[op.id] = heap.insert(op.key);
+            break;
+        case TRACE_DECREASE:
+            heap.decrease_key(handles[op.id], op.key);
+            break;
+        case TRACE_EXTRACT:
+            checksum += heap.extract_min();
+            break;
+        }
+    }
+
+    return checksum;
+}
+
+//find every key of the array q times over
+template<class Heap>
+void find_keys(const char *name, int *arr, int n, int q, bool indexed)
+{
+    Heap heap(arr, n);
+    if(indexed)
+        heap.enable_index();
+
+    long long checksum = 0;
+    auto start = high_resolution_clock::now();
+    for(int i=0; i<q; i++){
+        checksum += heap.find(arr[(i*7919) % n])->data;
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << q << " " << name
+         << (indexed ? " indexed" : " linear") << " find: "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+}
+
+//hold model, n inserts, then ops rounds of extract_min and insert
+template<class Heap>
+void hold(const char *name, Heap &heap, vector<int> &keys, int n, int ops)
+{
+    long long checksum = 0;
+    auto start = high_resolution_clock::now();
+    for(int i=0; i<n; i++){
+        heap.insert(keys[i]);
+    }
+    for(int i=0; i<ops; i++){
+        checksum += heap.extract_min();
+        heap.insert(keys[(n + i) % keys.size()]);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << name << ": "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+}
+
+template<class Heap>
+void run(const char *name, vector<TraceOp> &trace, int n)
+{
+    Heap heap;
+    auto start = high_resolution_clock::now();
+    long long checksum = replay(heap, trace, n);
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << name << ": "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+}
+
+#ifdef HEAP_STATS
+//replay the trace and export the stats of the heap as JSON
+template<class Heap>
+void stats_json(const char *name, vector<TraceOp> &trace, int n)
+{
+    Heap heap;
+    replay(heap, trace, n);
+    cout << name << " :";
+    heap.stats.json(cout);
+    cout << endl;
+}
+#endif
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=BENCH_SCALE;
+
+    // Decrease-key heavy workload
+    cout << "\n\tDecrease-key heavy workload" << endl;
+    vector<TraceOp> trace = decrease_key_heavy_trace(n, 10*n);
+    cout << "trace length :" << trace.size() << endl;
+    run<binary::IndexedBinaryHeap>("IndexedBinaryHeap", trace, n);
+    run<fibonacci::FibonacciHeap>("FibonacciHeap", trace, n);
+    run<fibonacci::CompactFibonacciHeap>("CompactFibonacciHeap", trace, n);
+    run<pairing::PairingHeap>("PairingHeap", trace, n);
+    run<rank_pairing::RankPairingHeap>("RankPairingHeap", trace, n);
+
+    // Dijkstra trace
+    cout << "\n\tDijkstra trace, degree 8" << endl;
+    trace = dijkstra_trace(n, 8);
+    cout << "trace length :" << trace.size() << endl;
+    run<binary::IndexedBinaryHeap>("IndexedBinaryHeap", trace, n);
+    run<fibonacci::FibonacciHeap>("FibonacciHeap", trace, n);
+    run<pairing::PairingHeap>("PairingHeap", trace, n);
+    run<radix::RadixHeap>("RadixHeap", trace, n);
+
+    // Hold model with bounded integer keys
+    int bits = 24;
+    cout << "\n\tHold model, " << bits << "-bit keys with duplicates" << endl;
+    vector<int> int_keys(4*n);
+    srand(2026);
+    for(int i=0; i<(int)int_keys.size(); i++){
+        int_keys[i] = (((unsigned)rand() << 8) ^ (unsigned)rand()) & ((1u<<bits) - 1);
+    }
+    {
+        binary::BinaryHeap binaryHeap(NULL, 0);
+        hold("BinaryHeap", binaryHeap, int_keys, n, 3*n);
+        fibonacci::FibonacciHeap fibonacciHeap;
+        hold("FibonacciHeap", fibonacciHeap, int_keys, n, 3*n);
+        pairing::PairingHeap pairingHeap;
+        hold("PairingHeap", pairingHeap, int_keys, n, 3*n);
+        bitset::BitsetHeap bitsetHeap(1<<bits);
+        hold("BitsetHeap", bitsetHeap, int_keys, n, 3*n);
+    }
+
+    // Find by key
+    cout << "\n\tFind by key" << endl;
+    int *find_data = fibonacci::random_case(1, n);
+    int q = 200;
+    find_keys<fibonacci::FibonacciHeap>("FibonacciHeap", find_data, n, q, false);
+    find_keys<fibonacci::FibonacciHeap>("FibonacciHeap", find_data, n, q, true);
+    find_keys<binomial::BinomialHeap>("BinomialHeap", find_data, n, q, false);
+    find_keys<binomial::BinomialHeap>("BinomialHeap", find_data, n, q, true);
+    find_keys<leftist::LeftistHeap>("LeftistHeap", find_data, n, q, false);
+    find_keys<leftist::LeftistHeap>("LeftistHeap", find_data, n, q, true);
+
+#ifdef HEAP_STATS
+    // Operation stats
+    cout << "\n\tOperation stats, decrease-key heavy workload" << endl;
+    trace = decrease_key_heavy_trace(n, 10*n);
+    stats_json<binary::IndexedBinaryHeap>("IndexedBinaryHeap", trace, n);
+    stats_json<fibonacci::FibonacciHeap>("FibonacciHeap", trace, n);
+    stats_json<fibonacci::CompactFibonacciHeap>("CompactFibonacciHeap", trace, n);
+    stats_json<pairing::PairingHeap>("PairingHeap", trace, n);
+    stats_json<rank_pairing::RankPairingHeap>("RankPairingHeap", trace, n);
+    stats_json<leftist::LeftistHeap>("LeftistHeap", trace, n);
+    stats_json<leftist::SkewHeap>("SkewHeap", trace, n);
+
+    cout << "\n\tOperation stats, Dijkstra trace" << endl;
+    trace = dijkstra_trace(n, 8);
+    stats_json<radix::RadixHeap>("RadixHeap", trace, n);
+#endif
+
+    return 0;
+}
+/*==============================================================*/
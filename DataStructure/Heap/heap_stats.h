@@ -0,0 +1,238 @@
+/*****************************************************************
+Name    :heap_stats
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 every heap, bulk ops and replace_min
+    20261019 Initial Version
+*****************************************************************/
+#ifndef HEAP_STATS_H
+#define HEAP_STATS_H
+#include <vector>
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+
+/*==============================================================*/
+//Opt-in operation stats for the heaps, build with -DHEAP_STATS.
+//Without it the heaps have no stats member and the macros below
+//expand to nothing, so there is no cost at all.
+//
+//A heap with stats counts every operation with its latency in ns, and
+//records the shape metric of its own algorithm:
+//  BinaryHeap, IndexedBinaryHeap, DaryHeap, MinMaxHeap
+//                  levels a key moves in a sift
+//  BinomialHeap    roots merged by extract_min, levels a key moves up
+//  ArrayBinomialHeap, LazyBinomialHeap
+//                  roots merged by extract_min, levels a key moves up
+//  FibonacciHeap, CompactFibonacciHeap
+//                  root list length before consolidate, cascade cuts
+//  PairingHeap, RankPairingHeap
+//                  subtrees melded by extract_min
+//  RankPairingHeap ranks fixed by decrease_key
+//  LeftistHeap, SkewHeap
+//                  right spine length of a meld
+//  RadixHeap       keys moved down by extract_min
+//BitsetHeap counts the operations only, each one walks a fixed number of
+//words. push_bulk and pop_k are counted once per call.
+//Every one goes into a histogram, heap.stats.json(cout) exports them.
+
+enum HeapOp{
+    STATS_INSERT,
+    STATS_EXTRACT_MIN,
+    STATS_DECREASE_KEY,
+    STATS_DELETE,
+    STATS_MERGE,
+    STATS_REPLACE_MIN,
+    STATS_PUSH_BULK,
+    STATS_POP_K,
+    STATS_EXTRACT_MAX,
+    STATS_OPS
+};
+
+enum HeapMetric{
+    STATS_SIFT_DEPTH,
+    STATS_ROOT_LIST,
+    STATS_CASCADE_CUT,
+    STATS_RIGHT_SPINE,
+    STATS_RANK_FIX,
+    STATS_REDISTRIBUTE,
+    STATS_METRICS
+};
+
+//HDR-style histogram, exact below 2*SUB, above that every power of two
+//is split into SUB buckets, so a value is off by at most 1/SUB.
+//The buckets are allocated at the first record.
+class StatsHistogram{
+    static const int SUB_BITS = 5;
+    static const int SUB = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS) * SUB + SUB;
+
+    std::vector<uint64_t> bucket;
+
+    int bucketOf(uint64_t value);
+    uint64_t valueOf(int index);
+public:
+    uint64_t count=0;
+    uint64_t sum=0;
+    uint64_t min=UINT64_MAX;
+    uint64_t max=0;
+
+    void record(uint64_t value);
+    uint64_t percentile(double p);
+    void reset(void);
+    void json(std::ostream &out);
+};
+
+inline int StatsHistogram::bucketOf(uint64_t value)
+{
+    if(value < 2*SUB)
+        return value;
+
+    int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+    return shift*SUB + (value >> shift);
+}
+
+//the middle of the bucket
+inline uint64_t StatsHistogram::valueOf(int index)
+{
+    if(index < 2*SUB)
+        return index;
+
+    int shift = index/SUB - 1;
+    uint64_t low = (uint64_t)(index%SUB + SUB) << shift;
+    return low + (((uint64_t)1 << shift) >> 1);
+}
+
+inline void StatsHistogram::record(uint64_t value)
+{
+    if(bucket.empty()){
+        bucket.assign(BUCKETS, 0);
+    }
+    bucket[bucketOf(value)]++;
+
+    count++;
+    sum += value;
+    if(value < min)
+        min = value;
+    if(value > max)
+        max = value;
+}
+
+//the value at or below which p percent of the records are
+inline uint64_t StatsHistogram::percentile(double p)
+{
+    if(0 == count)
+        return 0;
+
+    uint64_t target = (uint64_t)(p / 100.0 * count + 0.5);
+    if(target < 1)
+        target = 1;
+
+    uint64_t seen = 0;
+    for(int i=0; i<BUCKETS; i++){
+        seen += bucket[i];
+        if(seen >= target){
+            uint64_t value = valueOf(i);
+            return (value > max) ? max : value;
+        }
+    }
+    return max;
+}
+
+inline void StatsHistogram::reset(void)
+{
+    bucket.clear();
+    count = 0;
+    sum = 0;
+    min = UINT64_MAX;
+    max = 0;
+}
+
+inline void StatsHistogram::json(std::ostream &out)
+{
+    out << "{\"count\":" << count;
+    if(count){
+        out << ",\"min\":" << min
+            << ",\"max\":" << max
+            << ",\"mean\":" << (double)sum / count
+            << ",\"p50\":" << percentile(50)
+            << ",\"p90\":" << percentile(90)
+            << ",\"p99\":" << percentile(99)
+            << ",\"p999\":" << percentile(99.9);
+    }
+    out << "}";
+}
+
+//the stats of one heap
+class HeapStats{
+public:
+    StatsHistogram latency[STATS_OPS];      //ns per operation
+    StatsHistogram metrics[STATS_METRICS];
+
+    void reset(void);
+    void json(std::ostream &out);
+};
+
+inline void HeapStats::reset(void)
+{
+    for(int i=0; i<STATS_OPS; i++){
+        latency[i].reset();
+    }
+    for(int i=0; i<STATS_METRICS; i++){
+        metrics[i].reset();
+    }
+}
+
+//{"ops":{"insert":{...},...},"metrics":{...}}, a metric the heap never
+//records is left out
+inline void HeapStats::json(std::ostream &out)
+{
+    const char *op_names[STATS_OPS] = {
+        "insert", "extract_min", "decrease_key", "delete", "merge",
+        "replace_min", "push_bulk", "pop_k", "extract_max"};
+    const char *metric_names[STATS_METRICS] = {
+        "sift_depth", "root_list", "cascade_cut", "right_spine",
+        "rank_fix", "redistribute"};
+
+    out << "{\"ops\":{";
+    for(int i=0; i<STATS_OPS; i++){
+        out << (i ? "," : "") << "\"" << op_names[i] << "\":";
+        latency[i].json(out);
+    }
+    out << "},\"metrics\":{";
+    bool first = true;
+    for(int i=0; i<STATS_METRICS; i++){
+        if(0 == metrics[i].count)
+            continue;
+
+        out << (first ? "" : ",") << "\"" << metric_names[i] << "\":";
+        metrics[i].json(out);
+        first = false;
+    }
+    out << "}}";
+}
+
+//time one operation until the end of the scope
+class HeapStatsTimer{
+    StatsHistogram &histogram;
+    std::chrono::steady_clock::time_point start;
+public:
+    HeapStatsTimer(HeapStats &stats, HeapOp op)
+        : histogram(stats.latency[op]), start(std::chrono::steady_clock::now()){}
+    ~HeapStatsTimer(){
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+//inside a member function of a heap with a stats member
+#ifdef HEAP_STATS
+#define HEAP_STATS_OP(op) HeapStatsTimer heap_stats_timer(stats, op)
+#define HEAP_STATS_RECORD(m, value) stats.metrics[m].record(value)
+#else
+#define HEAP_STATS_OP(op)
+#define HEAP_STATS_RECORD(m, value) ((void)sizeof(value))
+#endif
+
+#endif
@@ -0,0 +1,329 @@
+/*****************************************************************
+Name    :heap_trace
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 drop the id of an extracted handle
+    20261019 Initial Version
+*****************************************************************/
+#ifndef HEAP_TRACE_H
+#define HEAP_TRACE_H
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+/*==============================================================*/
+//Binary trace of heap operations, for replaying a real workload
+//against every heap.
+//
+//File layout, little-endian:
+//  TraceHeader
+//  records, one type byte, then LEB128 varints
+//    TRACE_OP_INSERT        heap, id, key
+//    TRACE_OP_EXTRACT_MIN   heap
+//    TRACE_OP_DECREASE_KEY  heap, id, key
+//    TRACE_OP_DELETE        heap, id
+//    TRACE_OP_MERGE         heap, from
+//The keys are zigzag encoded. An id names one inserted element for its
+//whole life, even when a merge moves it to another heap. A merge leaves
+//the heap it takes from empty.
+
+#define TRACE_MAGIC (0x31525448)     //"HTR1"
+#define TRACE_VERSION (1)
+
+enum TraceOpType{
+    TRACE_OP_INSERT,
+    TRACE_OP_EXTRACT_MIN,
+    TRACE_OP_DECREASE_KEY,
+    TRACE_OP_DELETE,
+    TRACE_OP_MERGE,
+    TRACE_OPS
+};
+
+struct TraceHeader{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ops;
+    uint32_t ids;       //every id is below it
+    uint32_t heaps;     //every heap index is below it
+};
+
+//one decoded record, from is in id for a merge
+struct TraceRecord{
+    uint8_t type;
+    uint32_t heap;
+    uint32_t id;
+    int key;
+};
+
+//append records to a trace file, the header is written by close()
+class TraceWriter{
+    FILE *fp=NULL;
+    TraceHeader header;
+    std::vector<uint8_t> buffer;
+
+    void putVarint(uint64_t value);
+    void flush(void);
+public:
+    TraceWriter(const char *path);
+    ~TraceWriter();
+    bool ok(void);
+    void write(uint8_t type, uint32_t heap, uint32_t id, int key);
+    int new_id(void);
+    bool close(void);
+};
+
+inline TraceWriter::TraceWriter(const char *path)
+{
+    header = {TRACE_MAGIC, TRACE_VERSION, 0, 0, 0};
+    fp = fopen(path, "wb");
+    if(fp){
+        fwrite(&header, sizeof(header), 1, fp);
+    }
+}
+
+inline TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+inline bool TraceWriter::ok(void)
+{
+    return NULL != fp;
+}
+
+inline void TraceWriter::putVarint(uint64_t value)
+{
+    while(value >= 0x80){
+        buffer.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((uint8_t)value);
+}
+
+inline void TraceWriter::flush(void)
+{
+    if(fp && !buffer.empty()){
+        fwrite(buffer.data(), 1, buffer.size(), fp);
+    }
+    buffer.clear();
+}
+
+inline void TraceWriter::write(uint8_t type, uint32_t heap, uint32_t id, int key)
+{
+    buffer.push_back(type);
+    putVarint(heap);
+    if(TRACE_OP_INSERT == type || TRACE_OP_DECREASE_KEY == type || TRACE_OP_DELETE == type
+        || TRACE_OP_MERGE == type)
+    {
+        putVarint(id);
+    }
+    if(TRACE_OP_INSERT == type || TRACE_OP_DECREASE_KEY == type){
+        putVarint(((uint32_t)key << 1) ^ (uint32_t)(key >> 31));
+    }
+
+    header.ops++;
+    if(heap >= header.heaps){
+        header.heaps = heap + 1;
+    }
+    if(TRACE_OP_MERGE == type && id >= header.heaps){
+        header.heaps = id + 1;
+    }
+    if(buffer.size() >= (1<<16)){
+        flush();
+    }
+}
+
+//ids are handed out densely from 0
+inline int TraceWriter::new_id(void)
+{
+    return header.ids++;
+}
+
+inline bool TraceWriter::close(void)
+{
+    if(NULL == fp)
+        return false;
+
+    flush();
+    bool ok = (0 == fseek(fp, 0, SEEK_SET)) &&
+        (1 == fwrite(&header, sizeof(header), 1, fp));
+    ok = (0 == fclose(fp)) && ok;
+    fp = NULL;
+
+    return ok;
+}
+
+//read a whole trace, false if the file is not a valid trace
+inline bool read_trace(const char *path, TraceHeader &header, std::vector<TraceRecord> &records)
+{
+    FILE *fp = fopen(path, "rb");
+    if(NULL == fp)
+        return false;
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[1<<16];
+    size_t got;
+    while((got = fread(chunk, 1, sizeof(chunk), fp)) > 0){
+        bytes.insert(bytes.end(), chunk, chunk+got);
+    }
+    fclose(fp);
+
+    if(bytes.size() < sizeof(header))
+        return false;
+    memcpy(&header, bytes.data(), sizeof(header));
+    if(TRACE_MAGIC != header.magic || TRACE_VERSION != header.version)
+        return false;
+
+    size_t pos = sizeof(header);
+    bool valid = true;
+    auto varint = [&](uint64_t &value){
+        value = 0;
+        for(int shift=0; shift<64; shift+=7){
+            if(pos >= bytes.size()){
+                valid = false;
+                return;
+            }
+            uint8_t b = bytes[pos++];
+            value |= (uint64_t)(b & 0x7f) << shift;
+            if(0 == (b & 0x80))
+                return;
+        }
+        valid = false;
+    };
+
+    records.clear();
+    records.reserve(header.ops);
+    while(valid && pos < bytes.size()){
+        TraceRecord r = {bytes[pos++], 0, 0, 0};
+        uint64_t heap, id=0, zigzag=0;
+        varint(heap);
+        if(TRACE_OP_INSERT == r.type || TRACE_OP_DECREASE_KEY == r.type ||
+            TRACE_OP_DELETE == r.type || TRACE_OP_MERGE == r.type)
+        {
+            varint(id);
+        }
+        if(TRACE_OP_INSERT == r.type || TRACE_OP_DECREASE_KEY == r.type){
+            varint(zigzag);
+        }
+
+        //every index must be inside the header bounds
+        uint64_t id_bound = (TRACE_OP_MERGE == r.type) ? header.heaps : header.ids;
+        valid = valid && r.type < TRACE_OPS && heap < header.heaps &&
+            (TRACE_OP_EXTRACT_MIN == r.type || id < id_bound) &&
+            zigzag <= UINT32_MAX;
+        r.heap = heap;
+        r.id = id;
+        r.key = (int)((uint32_t)(zigzag >> 1) ^ -(uint32_t)(zigzag & 1));
+        records.push_back(r);
+    }
+
+    return valid && records.size() == header.ops;
+}
+
+//the handle of the min, from min_handle(), minNode or root, whichever
+//the heap has first
+template<class Heap>
+auto traceMinHandle(Heap &heap, int) -> decltype(heap.min_handle())
+{
+    return heap.min_handle();
+}
+
+template<class Heap>
+auto traceMinHandle(Heap &heap, long) -> decltype(heap.minNode)
+{
+    return heap.minNode;
+}
+
+template<class Heap>
+auto traceMinHandle(Heap &heap, ...) -> decltype(heap.root)
+{
+    return heap.root;
+}
+
+//Record every operation on a heap, it is used as the heap itself.
+//The recorders of one trace share the writer and have their own heap
+//index. The id of a handle is the one of its last insert, so the heap
+//must keep a handle with its key on decrease_key, like PairingHeap,
+//LeftistHeap or IndexedBinaryHeap, but not BinomialHeap.
+//The id of a handle is dropped when it is extracted or deleted, so the
+//map only holds the live elements.
+//Node handles are unique over all the heaps, so recorders that merge
+//can share one id map, made with the recorder to share it with, and
+//then a merge doesn't copy the ids.
+template<class Heap>
+class TraceRecorder{
+public:
+    typedef decltype(std::declval<Heap&>().insert(0)) Handle;
+private:
+    TraceWriter &writer;
+    std::unordered_map<Handle, int> own_ids;
+    std::unordered_map<Handle, int> &id_of;
+public:
+    Heap heap;
+    int index;
+
+    TraceRecorder(TraceWriter &writer, int index)
+        : writer(writer), id_of(own_ids), index(index){}
+    TraceRecorder(TraceWriter &writer, int index, TraceRecorder &share)
+        : writer(writer), id_of(share.id_of), index(index){}
+    Handle insert(int input);
+    int extract_min();
+    Handle decrease_key(Handle input, int new_val);
+    void delete_key(Handle input);
+    void merge(TraceRecorder &other);
+};
+
+template<class Heap>
+typename TraceRecorder<Heap>::Handle TraceRecorder<Heap>::insert(int input)
+{
+    Handle handle = heap.insert(input);
+    int id = writer.new_id();
+    id_of[handle] = id;
+    writer.write(TRACE_OP_INSERT, index, id, input);
+
+    return handle;
+}
+
+template<class Heap>
+int TraceRecorder<Heap>::extract_min()
+{
+    writer.write(TRACE_OP_EXTRACT_MIN, index, 0, 0);
+    id_of.erase(traceMinHandle(heap, 0));
+    return heap.extract_min();
+}
+
+template<class Heap>
+typename TraceRecorder<Heap>::Handle TraceRecorder<Heap>::decrease_key(Handle input, int new_val)
+{
+    writer.write(TRACE_OP_DECREASE_KEY, index, id_of[input], new_val);
+    return heap.decrease_key(input, new_val);
+}
+
+template<class Heap>
+void TraceRecorder<Heap>::delete_key(Handle input)
+{
+    writer.write(TRACE_OP_DELETE, index, id_of[input], 0);
+    id_of.erase(input);
+    heap.delete_key(input);
+}
+
+template<class Heap>
+void TraceRecorder<Heap>::merge(TraceRecorder &other)
+{
+    writer.write(TRACE_OP_MERGE, index, other.index, 0);
+    heap.merge(other.heap);
+    other.heap = Heap();
+    if(&id_of == &other.id_of)
+        return;
+
+    for(auto it=other.id_of.begin(); it!=other.id_of.end(); it++){
+        id_of[it->first] = it->second;
+    }
+    other.id_of.clear();
+}
+
+#endif
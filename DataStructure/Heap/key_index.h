@@ -0,0 +1,163 @@
+/*****************************************************************
+Name    :key_index
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 Initial Version
+*****************************************************************/
+#ifndef KEY_INDEX_H
+#define KEY_INDEX_H
+#include <vector>
+#include <cstdint>
+
+/*==============================================================*/
+//Open-addressing hash index from key to node for the node-based heaps.
+//Linear probing with backward-shift deletion, so there is no tombstone.
+//A duplicate key takes its own slot, erase and relink match the node.
+template<class T>
+class KeyIndex{
+    std::vector<int> keys;
+    std::vector<T*> nodes;     //NULL is an empty slot
+    int count=0;
+    int bits=0;
+
+    int home(int key);
+    int locate(int key, T *node);
+    void grow(void);
+public:
+    KeyIndex();
+    void insert(int key, T *node);
+    void erase(int key, T *node);
+    void relink(int key, T *from, T *to);
+    T *find(int key);
+    void clear(void);
+    int size(void);
+};
+
+template<class T>
+KeyIndex<T>::KeyIndex()
+{
+    clear();
+}
+
+//fibonacci hashing
+template<class T>
+int KeyIndex<T>::home(int key)
+{
+    return ((uint32_t)key * 2654435761u) >> (32 - bits);
+}
+
+//the slot holding the pair, -1 if not found
+template<class T>
+int KeyIndex<T>::locate(int key, T *node)
+{
+    int mask = nodes.size() - 1;
+    for(int i=home(key); nodes[i]; i=(i+1)&mask){
+        if(keys[i] == key && nodes[i] == node)
+            return i;
+    }
+    return -1;
+}
+
+//double the table when it is half full
+template<class T>
+void KeyIndex<T>::grow(void)
+{
+    std::vector<int> old_keys;
+    std::vector<T*> old_nodes;
+    old_keys.swap(keys);
+    old_nodes.swap(nodes);
+
+    bits++;
+    keys.assign(1<<bits, 0);
+    nodes.assign(1<<bits, (T*)NULL);
+    count = 0;
+    for(int i=0; i<(int)old_nodes.size(); i++){
+        if(old_nodes[i]){
+            insert(old_keys[i], old_nodes[i]);
+        }
+    }
+}
+
+template<class T>
+void KeyIndex<T>::insert(int key, T *node)
+{
+    if(2*(count+1) > (int)nodes.size()){
+        grow();
+    }
+
+    int mask = nodes.size() - 1;
+    int i = home(key);
+    while(nodes[i]){
+        i = (i+1) & mask;
+    }
+    keys[i] = key;
+    nodes[i] = node;
+    count++;
+}
+
+template<class T>
+void KeyIndex<T>::erase(int key, T *node)
+{
+    int i = locate(key, node);
+    if(i < 0)
+        return;
+
+    //shift back the entries that probed past the hole
+    int mask = nodes.size() - 1;
+    int j = i;
+    while(true){
+        j = (j+1) & mask;
+        if(NULL == nodes[j])
+            break;
+
+        int h = home(keys[j]);
+        bool stay = (i < j) ? (i < h && h <= j) : (i < h || h <= j);
+        if(stay)
+            continue;
+
+        keys[i] = keys[j];
+        nodes[i] = nodes[j];
+        i = j;
+    }
+    nodes[i] = NULL;
+    count--;
+}
+
+//the key moved from one node to another, e.g. by a value swap
+template<class T>
+void KeyIndex<T>::relink(int key, T *from, T *to)
+{
+    int i = locate(key, from);
+    if(i >= 0){
+        nodes[i] = to;
+    }
+}
+
+template<class T>
+T *KeyIndex<T>::find(int key)
+{
+    int mask = nodes.size() - 1;
+    for(int i=home(key); nodes[i]; i=(i+1)&mask){
+        if(keys[i] == key)
+            return nodes[i];
+    }
+    return NULL;
+}
+
+template<class T>
+void KeyIndex<T>::clear(void)
+{
+    bits = 4;
+    keys.assign(1<<bits, 0);
+    nodes.assign(1<<bits, (T*)NULL);
+    count = 0;
+}
+
+template<class T>
+int KeyIndex<T>::size(void)
+{
+    return count;
+}
+
+#endif
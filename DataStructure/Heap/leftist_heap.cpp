@@ -3,6 +3,11 @@ Name    :leftist_heap
 Author  :srhuang
 Email   :lukyandy3162@gmail.com
 History :
+    20261019 stats for the skew heap
+    20261019 opt-in operation stats
+    20261019 parallel construction by pairwise meld
+    20261019 iterative meld, skew heap
+    20261019 optional hash index for find
     20191226 decrease-key, delete, find.
     20191226 reconstruct
     20191218 change to min heap
@@ -11,8 +16,19 @@ History :
 #include <iostream>
 #include <vector>
 #include <queue>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include "key_index.h"
+#include "heap_stats.h"
 #define DEBUG (1)
 #define SCALE (10)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#ifndef PARALLEL_GRAIN
+#define PARALLEL_GRAIN (1<<16)
+#endif
 using namespace std;
 using namespace std::chrono;
 
@@ -31,6 +47,7 @@ struct Node{
 class LeftistHeap{
     //core operation
     Node *meld(Node *h1, Node *h2);
+    vector<Node*> spine;
 
     //inorder and preorder traversal
     void inorderTraversal(Node *parent);
@@ -38,12 +55,25 @@ class LeftistHeap{
 
     //inorder find
     Node *inorderFind(Node *parent, int key);
+
+    //add every node of the subtree into the index
+    void indexTree(Node *current);
 public:
     Node *root;
     int size;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //optional key -> node index
+    bool indexed=false;
+    KeyIndex<Node> index;
+    void enable_index(void);
 
     //five operations
+    LeftistHeap();
     LeftistHeap(int *arr, int size);
+    LeftistHeap(int *arr, int size, int threads);
     Node *insert(int input);
     int extract_min();
     int minimum();
@@ -61,52 +91,82 @@ public:
 };
 
 //core operation
+//walk down the right spines top-down, the smaller node stays on the
+//merged spine, then fix the leftist property and s-value bottom-up.
 Node *LeftistHeap::meld(Node *h1, Node *h2)
 {
-    Node *meld_root;
-    Node *meld_child;
-
-    //check the null head
-    if(NULL == h1){
-        return h2;
-    }
-    if(NULL == h2){
-        return h1;
+    //check the null head, the result is always a root
+    if(NULL == h1 || NULL == h2){
+        Node *meld_root = h1 ? h1 : h2;
+        if(meld_root)
+            meld_root->parent = NULL;
+        return meld_root;
     }
 
     //pick the new root
     if(h2->data < h1->data){
-        meld_root = h2;
-        meld_child = h1;
-    }else{
-        meld_root = h1;
-        meld_child = h2;
+        Node *temp = h1;
+        h1 = h2;
+        h2 = temp;
     }
-
-    //recursive meld the right child
-    meld_root->right = meld(meld_root->right, meld_child);
+    Node *meld_root = h1;
     meld_root->parent = NULL;
-    meld_root->right->parent = meld_root;
 
-    //check the leftist
-    if(NULL == meld_root->left){
-        meld_root->left = meld_root->right;
-        meld_root->right = NULL;
-    }else{
+    //h1 is on the merged spine, h2 is the rest to meld
+    spine.clear();
+    while(true){
+        spine.push_back(h1);
+
+        Node *right = h1->right;
+        if(NULL == right){
+            h1->right = h2;
+            h2->parent = h1;
+            break;
+        }
+
+        if(h2->data < right->data){
+            h1->right = h2;
+            h2->parent = h1;
+            h1 = h2;
+            h2 = right;
+        }else{
+            h1 = right;
+        }
+    }
+
+    //bottom-up update the s-value
+    for(int i=spine.size()-1; i>=0; i--){
+        Node *current = spine[i];
+
+        //check the leftist
+        if(NULL == current->left){
+            current->left = current->right;
+            current->right = NULL;
+            current->s_value = 1;
+            continue;
+        }
+
         //check the s value
-        if(meld_root->left->s_value < meld_root->right->s_value){
+        if(current->left->s_value < current->right->s_value){
             Node *temp;
-            temp = meld_root->left;
-            meld_root->left = meld_root->right;
-            meld_root->right = temp;
+            temp = current->left;
+            current->left = current->right;
+            current->right = temp;
         }
 
-        meld_root->s_value = meld_root->right->s_value + 1;
+        current->s_value = current->right->s_value + 1;
     }
+    HEAP_STATS_RECORD(STATS_RIGHT_SPINE, spine.size());
 
     return meld_root;
 }
 
+LeftistHeap::LeftistHeap()
+{
+    root = NULL;
+    size = 0;
+}
+
 //Initialize
 LeftistHeap::LeftistHeap(int *arr, int size)
 {
@@ -140,9 +200,57 @@ LeftistHeap::LeftistHeap(int *arr, int size)
     q.pop();
 }
 
+//Initialize in parallel
+//every thread builds the heap of one slice, then the heaps are melded
+//pairwise round by round, the pairs of one round meld in parallel.
+//Each part is its own heap, so every thread has its own meld spine.
+LeftistHeap::LeftistHeap(int *arr, int size, int threads) : LeftistHeap()
+{
+    if(threads > size / PARALLEL_GRAIN)
+        threads = size / PARALLEL_GRAIN;
+    if(threads < 1)
+        threads = 1;
+    if(0 == size)
+        return;
+
+    vector<LeftistHeap*> part(threads);
+    vector<thread> workers;
+    for(int t=0; t<threads; t++){
+        int lo = (long long)size*t/threads;
+        int hi = (long long)size*(t+1)/threads;
+        workers.push_back(thread([&part, arr, t, lo, hi](){
+            part[t] = new LeftistHeap(arr+lo, hi-lo);
+        }));
+    }
+    for(int t=0; t<threads; t++){
+        workers[t].join();
+    }
+
+    for(int step=1; step<threads; step*=2){
+        workers.clear();
+        for(int t=0; t+step<threads; t+=2*step){
+            workers.push_back(thread([&part, t, step](){
+                part[t]->merge(*part[t+step]);
+            }));
+        }
+        for(int i=0; i<(int)workers.size(); i++){
+            workers[i].join();
+        }
+    }
+
+    //take over the melded tree
+    root = part[0]->root;
+    this->size = size;
+    for(int t=0; t<threads; t++){
+        part[t]->root = NULL;
+        delete part[t];
+    }
+}
+
 //insert
 Node* LeftistHeap::insert(int input)
 {
+    HEAP_STATS_OP(STATS_INSERT);
     Node *newNode = new Node;
     newNode->data = input;
     root = meld(root, newNode);
@@ -150,27 +258,34 @@ Node* LeftistHeap::insert(int input)
     //update size
     size++;
 
+    if(indexed)
+        index.insert(input, newNode);
+
     return newNode;
 }
 
 //extract_min
 int LeftistHeap::extract_min()
 {
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
     if(NULL == root)
         return -1;
 
     Node *pre = root;
+    int result = pre->data;
 
     //meld two subtree
     root = meld(root->left, root->right);
 
     //delete
+    if(indexed)
+        index.erase(pre->data, pre);
     delete pre;
 
     //update size
     size--;
 
-    return pre->data;
+    return result;
 }
 
 //minimum
@@ -185,17 +300,27 @@ int LeftistHeap::minimum()
 //merge
 void LeftistHeap::merge(LeftistHeap &lh)
 {
+    HEAP_STATS_OP(STATS_MERGE);
+    if(indexed)
+        indexTree(lh.root);
+
     root = meld(root, lh.root);
     size = size + lh.size;
 }
 
 Node *LeftistHeap::decrease_key(Node *input, int new_val)
 {
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
     if(NULL == input)
         return NULL;
     if(input->data <= new_val)
         return input;
 
+    if(indexed){
+        index.erase(input->data, input);
+        index.insert(new_val, input);
+    }
+
     input->data = new_val;
     Node *current = input;
     Node *parent = input->parent;
@@ -248,6 +373,7 @@ Node *LeftistHeap::decrease_key(Node *input, int new_val)
 
 void LeftistHeap::delete_key(Node *input)
 {
+    HEAP_STATS_OP(STATS_DELETE);
     if(NULL == input)
         return;
 
@@ -303,6 +429,8 @@ void LeftistHeap::delete_key(Node *input)
 
     //setp 3 : delete the node and update size
     //cout << "delete" << endl;
+    if(indexed)
+        index.erase(input->data, input);
     delete input;
     size--;
 }
@@ -331,9 +459,34 @@ Node *LeftistHeap::inorderFind(Node *parent, int key)
 //find
 Node *LeftistHeap::find(int key)
 {
+    if(indexed)
+        return index.find(key);
+
     return inorderFind(root, key);
 }
 
+//preorder over the subtree
+void LeftistHeap::indexTree(Node *current)
+{
+    if(NULL == current)
+        return;
+
+    index.insert(current->data, current);
+    indexTree(current->left);
+    indexTree(current->right);
+}
+
+//build the index of the current nodes, kept up to date from now on
+void LeftistHeap::enable_index(void)
+{
+    if(indexed)
+        return;
+
+    indexed = true;
+    index.clear();
+    indexTree(root);
+}
+
 //binary tree preorder traversal
 void LeftistHeap::preorderTraversal(Node *currentNode)
 {
@@ -375,6 +528,257 @@ void LeftistHeap::dump(void)
     cout << endl;
 }
 
+//Skew heap
+//the self-adjusting variant, every node on the merge path swaps its
+//children, so there is no s-value to keep.
+class SkewHeap{
+    //core operation
+    Node *meld(Node *h1, Node *h2);
+    void replace(Node *input, Node *subtree);
+public:
+    Node *root=NULL;
+    int size=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    SkewHeap();
+    SkewHeap(int *arr, int size);
+    SkewHeap(int *arr, int size, int threads);
+    Node *insert(int input);
+    int extract_min();
+    int minimum();
+    void merge(SkewHeap &sh);
+
+    //decrease-key and delete
+    Node *decrease_key(Node *input, int new_val);
+    void delete_key(Node *input);
+
+    //find
+    Node *find(int key);
+};
+
+//core operation, top-down
+//the merged path goes to the left and the old left becomes the right
+Node *SkewHeap::meld(Node *h1, Node *h2)
+{
+    if(NULL == h1 || NULL == h2){
+        Node *meld_root = h1 ? h1 : h2;
+        if(meld_root)
+            meld_root->parent = NULL;
+        return meld_root;
+    }
+
+    if(h2->data < h1->data){
+        Node *temp = h1;
+        h1 = h2;
+        h2 = temp;
+    }
+    Node *meld_root = h1;
+    meld_root->parent = NULL;
+
+    int spine = 1;
+    Node *tail = h1;
+    h1 = tail->right;
+    tail->right = tail->left;
+    while(h1 && h2){
+        if(h2->data < h1->data){
+            Node *temp = h1;
+            h1 = h2;
+            h2 = temp;
+        }
+
+        tail->left = h1;
+        h1->parent = tail;
+        tail = h1;
+
+        h1 = tail->right;
+        tail->right = tail->left;
+        spine++;
+    }
+    HEAP_STATS_RECORD(STATS_RIGHT_SPINE, spine);
+
+    tail->left = h1 ? h1 : h2;
+    if(tail->left){
+        tail->left->parent = tail;
+    }
+
+    return meld_root;
+}
+
+//put the subtree in the place of the input node
+void SkewHeap::replace(Node *input, Node *subtree)
+{
+    Node *parent = input->parent;
+    if(subtree){
+        subtree->parent = parent;
+    }
+
+    if(NULL == parent){
+        root = subtree;
+    }else if(parent->left == input){
+        parent->left = subtree;
+    }else{
+        parent->right = subtree;
+    }
+}
+
+SkewHeap::SkewHeap()
+{
+
+}
+
+//Initialize
+SkewHeap::SkewHeap(int *arr, int size)
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//Initialize in parallel, the same pairwise meld as the leftist heap
+SkewHeap::SkewHeap(int *arr, int size, int threads)
+{
+    if(threads > size / PARALLEL_GRAIN)
+        threads = size / PARALLEL_GRAIN;
+    if(threads < 1)
+        threads = 1;
+
+    vector<SkewHeap*> part(threads);
+    vector<thread> workers;
+    for(int t=0; t<threads; t++){
+        int lo = (long long)size*t/threads;
+        int hi = (long long)size*(t+1)/threads;
+        workers.push_back(thread([&part, arr, t, lo, hi](){
+            part[t] = new SkewHeap(arr+lo, hi-lo);
+        }));
+    }
+    for(int t=0; t<threads; t++){
+        workers[t].join();
+    }
+
+    for(int step=1; step<threads; step*=2){
+        workers.clear();
+        for(int t=0; t+step<threads; t+=2*step){
+            workers.push_back(thread([&part, t, step](){
+                part[t]->merge(*part[t+step]);
+            }));
+        }
+        for(int i=0; i<(int)workers.size(); i++){
+            workers[i].join();
+        }
+    }
+
+    merge(*part[0]);
+    for(int t=0; t<threads; t++){
+        delete part[t];
+    }
+}
+
+//insert
+Node *SkewHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    Node *newNode = new Node;
+    newNode->data = input;
+    root = meld(root, newNode);
+    size++;
+
+    return newNode;
+}
+
+//extract_min
+int SkewHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NULL == root)
+        return -1;
+
+    Node *pre = root;
+    int result = pre->data;
+    root = meld(pre->left, pre->right);
+
+    delete pre;
+    size--;
+
+    return result;
+}
+
+//minimum
+int SkewHeap::minimum()
+{
+    if(NULL == root)
+        return -1;
+
+    return root->data;
+}
+
+//merge
+void SkewHeap::merge(SkewHeap &sh)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    root = meld(root, sh.root);
+    size = size + sh.size;
+
+    sh.root = NULL;
+    sh.size = 0;
+}
+
+//decrease key, cut the subtree and meld it with the root
+Node *SkewHeap::decrease_key(Node *input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NULL == input)
+        return NULL;
+    if(input->data <= new_val)
+        return input;
+
+    input->data = new_val;
+    if(input == root)
+        return input;
+
+    replace(input, NULL);
+    input->parent = NULL;
+    root = meld(root, input);
+
+    return input;
+}
+
+//delete, the meld of the two children takes its place
+void SkewHeap::delete_key(Node *input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NULL == input)
+        return;
+
+    Node *subtree = meld(input->left, input->right);
+    replace(input, subtree);
+
+    delete input;
+    size--;
+}
+
+//find, preorder without recursion
+Node *SkewHeap::find(int key)
+{
+    vector<Node*> stack;
+    if(root) stack.push_back(root);
+
+    while(!stack.empty()){
+        Node *current = stack.back();
+        stack.pop_back();
+
+        if(current->data == key)
+            return current;
+
+        if(current->right) stack.push_back(current->right);
+        if(current->left) stack.push_back(current->left);
+    }
+
+    return NULL;
+}
+
 /*==============================================================*/
 //Function area
 int *random_case(int base, int number)
@@ -389,7 +793,7 @@ int *random_case(int base, int number)
     //swap each position
     srand(time(NULL));
     for(int i=0; i<number-1; i++){
-        int j = i + rand() / (RAND_MAX / (number-i));
+        int j = i + rand() % (number-i);
         //swap
         int t=result[i];
         result[i] = result[j];
@@ -493,6 +897,100 @@ int main(int argc, char const *argv[]){
     }
     cout << endl;
 
+    // Skew heap
+    cout << "\n\tSkew heap" << endl;
+    SkewHeap mySkewHeap(random_data, n);
+    mySkewHeap.decrease_key(mySkewHeap.find(5), 0);
+    mySkewHeap.delete_key(mySkewHeap.find(7));
+    cout << "decrease-key 5 to 0, delete 7" << endl;
+    cout << "Heap sort :";
+    while(mySkewHeap.root){
+        cout << mySkewHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark insert and extract_min
+    cout << "\n\tBenchmark insert and extract_min" << endl;
+    int bench_n = BENCH_SCALE;
+    int *bench_random = random_case(1, bench_n);
+    int *bench_ascending = new int[bench_n];
+    for(int i=0; i<bench_n; i++){
+        bench_ascending[i] = i+1;
+    }
+    int *bench_cases[] = {bench_random, bench_ascending};
+    const char *bench_names[] = {"random", "ascending"};
+    long long checksum = 0;
+
+    for(int c=0; c<2; c++){
+        int *bench_data = bench_cases[c];
+
+        auto start = high_resolution_clock::now();
+        LeftistHeap benchHeap;
+        for(int i=0; i<bench_n; i++){
+            benchHeap.insert(bench_data[i]);
+        }
+        for(int i=0; i<bench_n; i++){
+            checksum += benchHeap.extract_min();
+        }
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by leftist heap, " << bench_names[c] << ": "
+             << duration.count() << " microseconds" << endl;
+
+        start = high_resolution_clock::now();
+        SkewHeap benchSkewHeap;
+        for(int i=0; i<bench_n; i++){
+            benchSkewHeap.insert(bench_data[i]);
+        }
+        for(int i=0; i<bench_n; i++){
+            checksum += benchSkewHeap.extract_min();
+        }
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by skew heap, " << bench_names[c] << ": "
+             << duration.count() << " microseconds" << endl;
+    }
+    cout << "checksum :" << checksum << endl;
+
+    // Benchmark parallel construction
+    //build with -DBENCH_SCALE=100000000 for the startup-size heap
+    cout << "\n\tBenchmark parallel construction" << endl;
+    int bench_threads = max(4u, thread::hardware_concurrency());
+    checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    LeftistHeap serialHeap(bench_random, bench_n);
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by serial leftist heap: "
+         << duration.count() << " microseconds" << endl;
+    checksum += serialHeap.extract_min();
+
+    start = high_resolution_clock::now();
+    LeftistHeap parallelHeap(bench_random, bench_n, bench_threads);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by parallel leftist heap, " << bench_threads
+         << " threads: " << duration.count() << " microseconds" << endl;
+    checksum += parallelHeap.extract_min();
+
+    start = high_resolution_clock::now();
+    SkewHeap serialSkewHeap(bench_random, bench_n);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by serial skew heap: "
+         << duration.count() << " microseconds" << endl;
+    checksum += serialSkewHeap.extract_min();
+
+    start = high_resolution_clock::now();
+    SkewHeap parallelSkewHeap(bench_random, bench_n, bench_threads);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by parallel skew heap, " << bench_threads
+         << " threads: " << duration.count() << " microseconds" << endl;
+    checksum += parallelSkewHeap.extract_min();
+    cout << "checksum :" << checksum << endl;
+
     return 0;
 }
 /*==============================================================*/
\ No newline at end of file
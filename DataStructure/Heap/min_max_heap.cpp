@@ -0,0 +1,516 @@
+/*****************************************************************
+Name    :min_max_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 opt-in operation stats
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The synced pair of heaps in the benchmark, see binary_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+//Min-max heap, a double-ended priority queue
+//The same array layout as BinaryHeap. The levels alternate, the root
+//level is a min level, a node on a min level is no greater than all its
+//descendants and a node on a max level is no less than them.
+//The min is the root and the max is one of its two children.
+class MinMaxHeap{
+    //core operation
+    int level(int index);
+    bool isMinLevel(int index);
+    void swapData(int i, int j);
+    int trickleDown(int index);
+    int bubbleUp(int index);
+    int maxIndex(void);
+    int removeAt(int index);
+public:
+    vector<int> data;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    MinMaxHeap();
+    MinMaxHeap(int *arr, int size);
+    int insert(int input);
+    int extract_min();
+    int minimum();
+    void merge(MinMaxHeap &mh);
+
+    //the other end
+    int extract_max();
+    int maximum();
+
+    //delete by index
+    void delete_key(int index);
+
+    //find
+    int find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+MinMaxHeap::MinMaxHeap()
+{
+
+}
+
+//initialize, trickle down from the last parent like Floyd's heapify
+MinMaxHeap::MinMaxHeap(int *arr, int size)
+{
+    data = vector<int>(arr, arr+size);
+    for(int i=(size-2)/2; i>=0; i--){
+        trickleDown(i);
+    }
+}
+
+//the depth of index is floor(log2(index+1))
+int MinMaxHeap::level(int index)
+{
+    return 31 - __builtin_clz(index+1);
+}
+
+//even depths are min levels
+bool MinMaxHeap::isMinLevel(int index)
+{
+    return 0 == (level(index) & 1);
+}
+
+void MinMaxHeap::swapData(int i, int j)
+{
+    int temp = data[i];
+    data[i] = data[j];
+    data[j] = temp;
+}
+
+//core operation
+//on a min level the node goes down to the smallest of its children and
+//grandchildren, on a max level to the largest. After a move to a
+//grandchild the node may be on the wrong side of the child between.
+//Return the levels it moves down.
+int MinMaxHeap::trickleDown(int index)
+{
+    int size = data.size();
+    bool min_level = isMinLevel(index);
+    int from = index;
+
+    while(true){
+        int child = 2*index + 1;
+        if(child >= size)
+            break;
+
+        //the best of the children and the grandchildren
+        int best = child;
+        int candidates[6] = {child+1, 2*child+1, 2*child+2,
+                             2*child+3, 2*child+4, -1};
+        for(int i=0; candidates[i]>=0 && candidates[i]<size; i++){
+            int c = candidates[i];
+            if(min_level ? (data[c] < data[best]) : (data[c] > data[best])){
+                best = c;
+            }
+        }
+
+        if(min_level ? (data[best] >= data[index]) : (data[best] <= data[index]))
+            break;
+
+        swapData(best, index);
+        if(best <= child+1){
+            index = best;
+            break;
+        }
+
+        //best is a grandchild, check it against its parent
+        int parent = (best-1)/2;
+        if(min_level ? (data[best] > data[parent]) : (data[best] < data[parent])){
+            swapData(best, parent);
+        }
+        index = best;
+    }
+
+    return level(index) - level(from);
+}
+
+//core operation
+//first settle which kind of level the new node belongs to against its
+//parent, then climb over the grandparents of that kind.
+//Return the index it ends up at.
+int MinMaxHeap::bubbleUp(int index)
+{
+    if(0 == index)
+        return index;
+
+    bool min_level = isMinLevel(index);
+    int parent = (index-1)/2;
+    if(min_level ? (data[index] > data[parent]) : (data[index] < data[parent])){
+        swapData(index, parent);
+        index = parent;
+        min_level = !min_level;
+    }
+
+    while(index > 2){
+        int grandparent = ((index-1)/2 - 1)/2;
+        if(min_level ? (data[index] >= data[grandparent]) :
+                       (data[index] <= data[grandparent]))
+            break;
+
+        swapData(index, grandparent);
+        index = grandparent;
+    }
+
+    return index;
+}
+
+//the index of the max, the root if it has no children
+int MinMaxHeap::maxIndex(void)
+{
+    int size = data.size();
+    if(size <= 1)
+        return 0;
+    if(2 == size || data[1] >= data[2])
+        return 1;
+    return 2;
+}
+
+//core operation
+//the last element fills the hole. If it belongs on the other kind of
+//level than the hole, it swaps with the parent, the parent goes down
+//from the hole and it goes up from the parent. Otherwise it climbs
+//over the grandparents, or goes down if it can't.
+int MinMaxHeap::removeAt(int index)
+{
+    int result = data[index];
+    data[index] = data.back();
+    data.pop_back();
+    if(index >= (int)data.size())
+        return result;
+
+    int levels = 0;
+    int parent = (index-1)/2;
+    bool min_level = isMinLevel(index);
+    if(index > 0 &&
+        (min_level ? (data[index] > data[parent]) : (data[index] < data[parent])))
+    {
+        swapData(index, parent);
+        levels = trickleDown(index) + 1;
+        levels += level(parent) - level(bubbleUp(parent));
+    }else{
+        int moved = bubbleUp(index);
+        if(moved == index){
+            levels = trickleDown(index);
+        }else{
+            levels = level(index) - level(moved);
+        }
+    }
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, levels);
+
+    return result;
+}
+
+//insert, return the index it ends up at
+int MinMaxHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    data.push_back(input);
+
+    int index = data.size()-1;
+    int moved = bubbleUp(index);
+    HEAP_STATS_RECORD(STATS_SIFT_DEPTH, level(index) - level(moved));
+
+    return moved;
+}
+
+//extract min
+int MinMaxHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(data.empty())
+        return -1;
+
+    return removeAt(0);
+}
+
+//minimum
+int MinMaxHeap::minimum()
+{
+    if(data.empty())
+        return -1;
+
+    return data[0];
+}
+
+//extract max
+int MinMaxHeap::extract_max()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MAX);
+    if(data.empty())
+        return -1;
+
+    return removeAt(maxIndex());
+}
+
+//maximum
+int MinMaxHeap::maximum()
+{
+    if(data.empty())
+        return -1;
+
+    return data[maxIndex()];
+}
+
+//merge, append and build again
+void MinMaxHeap::merge(MinMaxHeap &mh)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    data.insert(data.end(), mh.data.begin(), mh.data.end());
+    int size = data.size();
+    for(int i=(size-2)/2; i>=0; i--){
+        trickleDown(i);
+    }
+}
+
+//delete
+void MinMaxHeap::delete_key(int index)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(index < 0 || index >= (int)data.size())
+        return;
+
+    removeAt(index);
+}
+
+//find
+int MinMaxHeap::find(int key)
+{
+    for(int i=0; i<(int)data.size(); i++){
+        if(data[i] == key)
+            return i;
+    }
+
+    return -1;
+}
+
+//dump elements, one level per line
+void MinMaxHeap::dump(void)
+{
+    cout << "Dump the heap :" << endl;
+    int size = data.size();
+    for(int first=0, depth=0; first<size; first=2*first+1, depth++){
+        cout << ((depth & 1) ? "max :" : "min :");
+        for(int i=first; i<size && i<2*first+1; i++){
+            cout << " " << data[i];
+        }
+        cout << endl;
+    }
+}
+
+//The way it was done before, a min heap and a max heap of negated keys
+//holding the same elements, every pop deletes the twin from the other.
+class SyncedHeaps{
+    binary::IndexedBinaryHeap minHeap;
+    binary::IndexedBinaryHeap maxHeap;
+    vector<int> twin_of_min;
+    vector<int> twin_of_max;
+public:
+    void insert(int input);
+    int extract_min();
+    int extract_max();
+    int size();
+};
+
+void SyncedHeaps::insert(int input)
+{
+    int min_handle = minHeap.insert(input);
+    int max_handle = maxHeap.insert(-input);
+    if(min_handle >= (int)twin_of_min.size()){
+        twin_of_min.resize(min_handle+1);
+    }
+    if(max_handle >= (int)twin_of_max.size()){
+        twin_of_max.resize(max_handle+1);
+    }
+    twin_of_min[min_handle] = max_handle;
+    twin_of_max[max_handle] = min_handle;
+}
+
+int SyncedHeaps::extract_min()
+{
+    int handle = minHeap.min_handle();
+    maxHeap.delete_key(twin_of_min[handle]);
+    return minHeap.extract_min();
+}
+
+int SyncedHeaps::extract_max()
+{
+    int handle = maxHeap.min_handle();
+    minHeap.delete_key(twin_of_max[handle]);
+    return -maxHeap.extract_min();
+}
+
+int SyncedHeaps::size()
+{
+    return minHeap.size();
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//admission and eviction: every round inserts two keys, then pops the
+//min and the max
+template<class Heap>
+long long admit_evict(const char *name, Heap &heap, int *arr, int n)
+{
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    for(int i=0; i<n/2; i++){
+        heap.insert(arr[i]);
+    }
+    for(int i=n/2; i+1<n; i+=2){
+        heap.insert(arr[i]);
+        heap.insert(arr[i+1]);
+        checksum += heap.extract_min();
+        checksum -= heap.extract_max();
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << name << ": "
+         << duration.count() << " microseconds, checksum :" << checksum << endl;
+
+    return checksum;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Initialize from the array
+    cout << "\n\tInitialize from the array" << endl;
+    MinMaxHeap myHeap(random_data, n);
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "maximum :" << myHeap.maximum() << endl;
+
+    // Insert the new element
+    cout << "\n\tInsert the new element" << endl;
+    myHeap.insert(0);
+    myHeap.insert(25);
+    myHeap.insert(13);
+    myHeap.dump();
+
+    // Test both ends
+    cout << "\n\tTest both ends" << endl;
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    cout << "extract_max :" << myHeap.extract_max() << endl;
+    cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "maximum :" << myHeap.maximum() << endl;
+
+    // Test delete and merge
+    cout << "\n\tTest delete and merge" << endl;
+    myHeap.delete_key(myHeap.find(7));
+    cout << "delete 7, find 7 :" << myHeap.find(7) << endl;
+    int random_data2[] = {30, 21, 27};
+    MinMaxHeap myHeap2(random_data2, 3);
+    myHeap.merge(myHeap2);
+    myHeap.dump();
+
+    // Heap sort from both ends
+    cout << "\n\tHeap sort from both ends" << endl;
+    cout << "ascending :";
+    MinMaxHeap sortHeap(random_data, n);
+    while(sortHeap.data.size()){
+        cout << sortHeap.extract_min() << " ";
+    }
+    cout << endl;
+    cout << "descending :";
+    while(myHeap.data.size()){
+        cout << myHeap.extract_max() << " ";
+    }
+    cout << endl;
+
+    // Benchmark admission and eviction
+    cout << "\n\tBenchmark admission and eviction" << endl;
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+
+    MinMaxHeap benchHeap;
+    admit_evict("min-max heap", benchHeap, bench_data, bench_n);
+    SyncedHeaps benchSynced;
+    admit_evict("synced min and max heaps", benchSynced, bench_data, bench_n);
+
+    // Benchmark construction
+    cout << "\n\tBenchmark construction" << endl;
+    auto start = high_resolution_clock::now();
+    MinMaxHeap buildHeap(bench_data, bench_n);
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by O(n) build: "
+         << duration.count() << " microseconds" << endl;
+    cout << "minimum :" << buildHeap.minimum()
+         << ", maximum :" << buildHeap.maximum() << endl;
+
+    return 0;
+}
+/*==============================================================*/
@@ -0,0 +1,345 @@
+/*****************************************************************
+Name    :multi_queue
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#define MAX_THREADS (64)
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The shards are plain binary heaps, see binary_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+//Relaxed concurrent priority queue, c*T binary heaps behind their own lock.
+//insert goes to a random shard, extract_min takes the better top of two
+//random shards, so the result is close to the min but not always the min.
+//The top of every shard is cached for the lock-free comparison, INT_MAX
+//marks an empty shard, so INT_MAX itself can not be a key.
+struct alignas(64) Shard{
+    mutex lock;
+    atomic<int> top;
+    binary::BinaryHeap heap;
+
+    Shard() : top(INT_MAX), heap(NULL, 0) {}
+};
+
+class MultiQueue{
+    Shard *shards;
+    int shard_count;
+
+    //element count, 0 means every shard is empty
+    atomic<int> number;
+
+    int randomShard(void);
+    void publish(Shard &shard);
+public:
+    MultiQueue(int threads, int c);
+    ~MultiQueue();
+    void insert(int input);
+    int extract_min();
+    int size();
+};
+
+//xorshift per thread
+int MultiQueue::randomShard(void)
+{
+    static thread_local uint32_t seed =
+        hash<thread::id>()(this_thread::get_id()) | 1;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    return seed % shard_count;
+}
+
+//cache the top, called with the lock held
+void MultiQueue::publish(Shard &shard)
+{
+    int top = shard.heap.data.empty() ? INT_MAX : shard.heap.data[0];
+    shard.top.store(top, memory_order_relaxed);
+}
+
+//Initialize
+MultiQueue::MultiQueue(int threads, int c)
+{
+    shard_count = threads * c;
+    shards = new Shard[shard_count];
+    number = 0;
+}
+
+MultiQueue::~MultiQueue()
+{
+    delete [] shards;
+}
+
+//insert, move on to another shard if the lock is taken
+void MultiQueue::insert(int input)
+{
+    while(true){
+        Shard &shard = shards[randomShard()];
+        if(!shard.lock.try_lock())
+            continue;
+
+        shard.heap.insert(input);
+        publish(shard);
+        shard.lock.unlock();
+        break;
+    }
+    number.fetch_add(1);
+}
+
+//extract min, the better of two random shards
+int MultiQueue::extract_min()
+{
+    while(true){
+        int i = randomShard();
+        int j = randomShard();
+        int top_i = shards[i].top.load(memory_order_relaxed);
+        int top_j = shards[j].top.load(memory_order_relaxed);
+
+        if(INT_MAX == top_i && INT_MAX == top_j){
+            if(0 == number.load())
+                return -1;
+            continue;
+        }
+
+        Shard &shard = shards[(top_j < top_i) ? j : i];
+        if(!shard.lock.try_lock())
+            continue;
+
+        //somebody else may have emptied it
+        if(shard.heap.data.empty()){
+            shard.lock.unlock();
+            continue;
+        }
+
+        int result = shard.heap.extract_min();
+        publish(shard);
+        shard.lock.unlock();
+        number.fetch_sub(1);
+
+        return result;
+    }
+}
+
+//size, exact only when nobody is working on the queue
+int MultiQueue::size()
+{
+    return number.load();
+}
+
+//The strict baseline, one binary heap behind one lock
+class LockedBinaryHeap{
+    mutex lock;
+    binary::BinaryHeap heap;
+public:
+    LockedBinaryHeap();
+    void insert(int input);
+    int extract_min();
+};
+
+LockedBinaryHeap::LockedBinaryHeap() : heap(NULL, 0)
+{
+
+}
+
+void LockedBinaryHeap::insert(int input)
+{
+    lock_guard<mutex> guard(lock);
+    heap.insert(input);
+}
+
+int LockedBinaryHeap::extract_min()
+{
+    lock_guard<mutex> guard(lock);
+    return heap.extract_min();
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//Rank error of draining the queue, the rank of an extracted key is the
+//number of smaller keys still in the queue, counted by a fenwick tree.
+//The keys must be a permutation of 1..n.
+void rank_error(int threads, int c, int *arr, int n)
+{
+    MultiQueue queue(threads, c);
+    vector<int> fenwick(n+1, 0);
+    for(int i=0; i<n; i++){
+        queue.insert(arr[i]);
+        for(int k=arr[i]; k<=n; k+=k&(-k)){
+            fenwick[k]++;
+        }
+    }
+
+    long long sum = 0;
+    int max_error = 0;
+    for(int i=0; i<n; i++){
+        int key = queue.extract_min();
+
+        int rank = 0;
+        for(int k=key-1; k>0; k-=k&(-k)){
+            rank += fenwick[k];
+        }
+        for(int k=key; k<=n; k+=k&(-k)){
+            fenwick[k]--;
+        }
+
+        sum += rank;
+        max_error = max(max_error, rank);
+    }
+
+    cout << "shards :" << threads*c
+         << ", mean rank error :" << (double)sum/n
+         << ", max rank error :" << max_error << endl;
+}
+
+//prefill, then every thread does its share of ops, half inserts and
+//half extract_min in random order
+template<class Queue>
+long long throughput(Queue &queue, int threads, int *arr, int n, int ops)
+{
+    for(int i=0; i<n; i++){
+        queue.insert(arr[i]);
+    }
+
+    atomic<long long> checksum(0);
+    vector<thread> workers;
+    auto start = high_resolution_clock::now();
+    for(int t=0; t<threads; t++){
+        workers.push_back(thread([&queue, &checksum, t, threads, arr, n, ops](){
+            uint32_t seed = 2026 + t;
+            long long local = 0;
+            for(int i=t; i<ops; i+=threads){
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                if(seed & 1){
+                    queue.insert(arr[i % n]);
+                }else{
+                    local += queue.extract_min();
+                }
+            }
+            checksum += local;
+        }));
+    }
+    for(int t=0; t<threads; t++){
+        workers[t].join();
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << threads << " threads: "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+
+    return duration.count();
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Insert and extract min
+    cout << "\n\tInsert and extract min" << endl;
+    MultiQueue myQueue(2, 2);
+    for(int i=0; i<n; i++){
+        myQueue.insert(random_data[i]);
+    }
+    cout << "size :" << myQueue.size() << endl;
+    cout << "Relaxed order :";
+    while(myQueue.size()){
+        cout << myQueue.extract_min() << " ";
+    }
+    cout << endl;
+    cout << "extract_min on empty :" << myQueue.extract_min() << endl;
+
+    // Rank error
+    n = BENCH_SCALE;
+    int *bench_data = random_case(1, n);
+    cout << "\n\tRank error, c = 2" << endl;
+    for(int threads=1; threads<=MAX_THREADS; threads*=4){
+        rank_error(threads, 2, bench_data, n);
+    }
+
+    // Thread scaling
+    int ops = 4 * n;
+    cout << "\n\tThread scaling, MultiQueue c = 2" << endl;
+    for(int threads=1; threads<=MAX_THREADS; threads*=2){
+        MultiQueue queue(threads, 2);
+        throughput(queue, threads, bench_data, n, ops);
+    }
+
+    cout << "\n\tThread scaling, BinaryHeap with one mutex" << endl;
+    for(int threads=1; threads<=MAX_THREADS; threads*=2){
+        LockedBinaryHeap heap;
+        throughput(heap, threads, bench_data, n, ops);
+    }
+
+    return 0;
+}
+/*==============================================================*/
@@ -0,0 +1,424 @@
+/*****************************************************************
+Name    :pairing_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 delete does not count an extract_min too
+    20261019 subtrees melded by the two passes
+    20261019 opt-in operation stats
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include "heap_stats.h"
+#define DEBUG (1)
+#define SCALE (20)
+using namespace std;
+
+/*==============================================================*/
+//Global area
+//Left-Child Right-sibling
+struct Node{
+    int data;
+    Node *child=NULL;
+    Node *sibling=NULL;
+
+    //previous sibling, or the parent for the first child
+    Node *prev=NULL;
+};
+
+class PairingHeap{
+    //core operation
+    Node *link(Node *n1, Node *n2);
+    Node *twoPass(Node *first);
+    int removeMin(void);
+    void detach(Node *input);
+
+    //preorder traversal
+    void preorderTraversal(Node *current);
+public:
+    Node *root=NULL;
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    PairingHeap();
+    PairingHeap(int *arr, int size);
+    Node *insert(int input);
+    int extract_min();
+    int minimum();
+    void merge(PairingHeap &ph);
+
+    //decrease-key and delete
+    Node *decrease_key(Node *input, int new_val);
+    void delete_key(Node *input);
+
+    //find
+    Node *find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+PairingHeap::PairingHeap()
+{
+
+}
+
+//core operation
+//the greater root becomes the first child of the less one
+Node *PairingHeap::link(Node *n1, Node *n2)
+{
+    Node *less = (n2->data < n1->data)? n2 : n1;
+    Node *greater = (n1 == less)? n2 : n1;
+
+    greater->prev = less;
+    greater->sibling = less->child;
+    if(less->child){
+        less->child->prev = greater;
+    }
+    less->child = greater;
+
+    return less;
+}
+
+//core operation
+//link the siblings in pairs from left to right, then link the pairs
+//from right to left into one tree.
+Node *PairingHeap::twoPass(Node *first)
+{
+    if(NULL == first)
+        return NULL;
+
+    //first pass, the pairs are kept in reverse order
+    int subtrees = 0;
+    Node *pairs = NULL;
+    while(first){
+        Node *n1 = first;
+        Node *n2 = first->sibling;
+        if(NULL == n2){
+            n1->prev = NULL;
+            n1->sibling = pairs;
+            pairs = n1;
+            subtrees++;
+            break;
+        }
+        first = n2->sibling;
+        subtrees += 2;
+
+        n1->prev = n1->sibling = NULL;
+        n2->prev = n2->sibling = NULL;
+        Node *pair = link(n1, n2);
+        pair->sibling = pairs;
+        pairs = pair;
+    }
+
+    //second pass
+    Node *result = pairs;
+    pairs = pairs->sibling;
+    result->sibling = NULL;
+    while(pairs){
+        Node *next = pairs->sibling;
+        pairs->sibling = NULL;
+        result = link(result, pairs);
+        pairs = next;
+    }
+    result->prev = NULL;
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, subtrees);
+
+    return result;
+}
+
+//cut the subtree of a non-root node
+void PairingHeap::detach(Node *input)
+{
+    if(input->prev->child == input){
+        input->prev->child = input->sibling;
+    }else{
+        input->prev->sibling = input->sibling;
+    }
+    if(input->sibling){
+        input->sibling->prev = input->prev;
+    }
+
+    input->prev = NULL;
+    input->sibling = NULL;
+}
+
+//Initialize
+PairingHeap::PairingHeap(int *arr, int size)
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//insert
+Node *PairingHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    Node *newNode = new Node();
+    newNode->data = input;
+
+    if(NULL == root){
+        root = newNode;
+    }else{
+        root = link(root, newNode);
+    }
+    number++;
+
+    return newNode;
+}
+
+//core operation, remove the min node, shared by extract_min and delete
+int PairingHeap::removeMin(void)
+{
+    Node *target = root;
+    int result = target->data;
+
+    root = twoPass(target->child);
+
+    delete target;
+    number--;
+
+    return result;
+}
+
+//extract_min
+int PairingHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NULL == root)
+        return -1;
+
+    return removeMin();
+}
+
+//minimum
+int PairingHeap::minimum()
+{
+    if(NULL == root)
+        return -1;
+
+    return root->data;
+}
+
+//merge
+void PairingHeap::merge(PairingHeap &ph)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    if(NULL == ph.root)
+        return;
+
+    if(NULL == root){
+        root = ph.root;
+    }else{
+        root = link(root, ph.root);
+    }
+    number += ph.number;
+
+    ph.root = NULL;
+    ph.number = 0;
+}
+
+//decrease key, cut the subtree and link it with the root
+Node *PairingHeap::decrease_key(Node *input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NULL == input)
+        return NULL;
+    if(input->data <= new_val)
+        return input;
+
+    input->data = new_val;
+    if(input == root)
+        return input;
+
+    detach(input);
+    root = link(root, input);
+
+    return input;
+}
+
+//delete, cut the subtree and link its two-pass result with the root
+void PairingHeap::delete_key(Node *input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NULL == input)
+        return;
+
+    if(input == root){
+        removeMin();
+        return;
+    }
+
+    detach(input);
+    Node *subtree = twoPass(input->child);
+    if(subtree){
+        root = link(root, subtree);
+    }
+
+    delete input;
+    number--;
+}
+
+//find, preorder without recursion, the sibling lists can be long
+Node *PairingHeap::find(int key)
+{
+    vector<Node*> stack;
+    if(root) stack.push_back(root);
+
+    while(!stack.empty()){
+        Node *current = stack.back();
+        stack.pop_back();
+
+        if(current->data == key)
+            return current;
+
+        if(current->sibling) stack.push_back(current->sibling);
+        if(current->child) stack.push_back(current->child);
+    }
+
+    return NULL;
+}
+
+//preorder traversal, children in parentheses
+void PairingHeap::preorderTraversal(Node *current)
+{
+    while(current){
+        cout << " " << current->data;
+        if(current->child){
+            cout << " (";
+            preorderTraversal(current->child);
+            cout << " )";
+        }
+        current = current->sibling;
+    }
+}
+
+//dump elements
+void PairingHeap::dump(void)
+{
+    cout << "Dump the heap :";
+    preorderTraversal(root);
+    cout << endl;
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Initialize from the array
+    cout << "\n\tInitialize from the array" << endl;
+    PairingHeap myHeap(random_data, n);
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Insert the new element
+    cout << "\n\tInsert the new element" << endl;
+    Node *temp = myHeap.insert(8);
+    myHeap.insert(15);
+    myHeap.insert(4);
+    myHeap.dump();
+
+    // Test minimum and extract min
+    cout << "\n\tTest minimum and extract min" << endl;
+    cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Test decrease-key and delete
+    cout << "\n\tTest decrease-key and delete" << endl;
+    int decrease_value = 7;
+    Node *decrease_node = myHeap.decrease_key(myHeap.find(7), 1);
+    cout << "decrease-key from " << decrease_value << " to "
+        << decrease_node->data << endl;
+    myHeap.dump();
+
+    cout << "\nBefore delete" << endl;
+    myHeap.dump();
+
+    myHeap.delete_key(myHeap.find(6));
+    myHeap.delete_key(temp);
+
+    cout << "After delete" << endl;
+    myHeap.dump();
+
+    // Find the value
+    int find_value = 9;
+    cout << "\n\tFind the value : " << find_value << endl;
+    Node *find_node = myHeap.find(find_value);
+    cout << "Find Node :";
+    if(NULL != find_node){
+        cout << find_node->data << endl;
+    }else{
+        cout << "NULL" << endl;
+    }
+
+    // Merge the two heap
+    cout << "\n\tMerge the two heap" << endl;
+    n=13;
+    int *random_data2 = random_case(50, n);
+#if DEBUG
+    cout << "Generate Data2 :";
+    for(int i=0; i<n; i++){
+        cout << random_data2[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    PairingHeap myHeap2(random_data2, n);
+    myHeap2.dump();
+
+    myHeap.merge(myHeap2);
+    myHeap.dump();
+
+    // Heap sort
+    cout << "\n\tHeap sort" << endl;
+    cout << "Heap sort :";
+    while(myHeap.root){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    return 0;
+}
+/*==============================================================*/
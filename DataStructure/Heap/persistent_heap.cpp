@@ -0,0 +1,726 @@
+/*****************************************************************
+Name    :persistent_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 replay the whole log, the header may be ahead of the array
+    20261019 fail the operation on a log write error
+    20261019 replay every record of the log
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#define DEBUG (1)
+#define SCALE (10)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#define HEAP_MAGIC (0x50484541u)
+#define LOG_MAGIC (0x504c4f47u)
+#define INITIAL_CAPACITY (1024)
+#define LOG_LIMIT (1<<26)
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The heap file is the header followed by the array, the file size gives
+//the capacity. version is the sequence number of the last applied
+//operation and checksum covers the other three fields.
+struct HeapHeader{
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t version;
+    uint64_t size;
+    uint64_t checksum;
+};
+
+//One record of the intent log, followed by count (index, value) pairs,
+//a checksum of all of it, then the footer. A torn append has no valid
+//footer or checksum.
+struct LogRecord{
+    uint64_t seq;
+    uint64_t new_size;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct LogFooter{
+    uint32_t length;    //whole record with the footer
+    uint32_t magic;
+};
+
+//Binary heap in a memory-mapped file with a redo log
+//Every operation first works out the array slots it will write, appends
+//them with the new size to the log, and only then writes the array and
+//the header. An operation whose record is not fully written, or not
+//synced when durable, fails without touching the array, and the heap
+//takes no more writes until it is opened again.
+//checkpoint() syncs the array and empties the log, so the log always
+//starts at a synced array. The header and the array pages reach the disk
+//in no order, the header may be ahead of the array or behind it, so
+//reopening replays every record of the log in order. The writes are
+//absolute, so one that is already applied can be applied again. The
+//replay stops at the first torn record, the array was never touched by it.
+class PersistentBinaryHeap{
+    int heap_fd=-1;
+    int log_fd=-1;
+    HeapHeader *header=NULL;
+    size_t mapped=0;
+    long long log_size=0;
+
+    //the writes of the operation in progress
+    vector<int> write_index;
+    vector<int> write_value;
+
+    //core operation
+    static uint64_t hashBytes(const void *buf, size_t len, uint64_t h);
+    uint64_t headerChecksum(void);
+    bool remap(size_t bytes);
+    bool reserve(uint64_t count);
+    bool redo(char *record);
+    bool recover(void);
+    bool commit(uint64_t new_size);
+public:
+    int *data=NULL;
+    uint64_t capacity=0;
+
+    //fdatasync the log on every operation
+    bool durable=false;
+
+    //test hook, exit right after the log record is written
+    bool crash_after_log=false;
+
+    //operations replayed from the log by open
+    int replayed=0;
+
+    //a log write failed, no more writes until open
+    bool io_error=false;
+
+    PersistentBinaryHeap();
+    ~PersistentBinaryHeap();
+    bool open(const char *path);
+    void close(void);
+    void checkpoint(void);
+
+    int insert(int input);
+    int extract_min();
+    int minimum();
+    int size();
+
+    //dump elements
+    void dump(void);
+};
+
+PersistentBinaryHeap::PersistentBinaryHeap()
+{
+
+}
+
+PersistentBinaryHeap::~PersistentBinaryHeap()
+{
+    close();
+}
+
+//FNV-1a
+uint64_t PersistentBinaryHeap::hashBytes(const void *buf, size_t len, uint64_t h)
+{
+    const unsigned char *p = (const unsigned char *)buf;
+    for(size_t i=0; i<len; i++){
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t PersistentBinaryHeap::headerChecksum(void)
+{
+    return hashBytes(header, offsetof(HeapHeader, checksum), 14695981039346656037ull);
+}
+
+//map the first bytes of the heap file
+bool PersistentBinaryHeap::remap(size_t bytes)
+{
+    if(header){
+        munmap(header, mapped);
+        header = NULL;
+    }
+
+    void *addr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, heap_fd, 0);
+    if(MAP_FAILED == addr)
+        return false;
+
+    header = (HeapHeader *)addr;
+    data = (int *)(header + 1);
+    mapped = bytes;
+    capacity = (bytes - sizeof(HeapHeader)) / sizeof(int);
+
+    return true;
+}
+
+//double the file until count elements fit
+bool PersistentBinaryHeap::reserve(uint64_t count)
+{
+    if(count <= capacity)
+        return true;
+
+    uint64_t new_capacity = capacity ? capacity : INITIAL_CAPACITY;
+    while(new_capacity < count){
+        new_capacity *= 2;
+    }
+
+    size_t bytes = sizeof(HeapHeader) + new_capacity*sizeof(int);
+    if(ftruncate(heap_fd, bytes) < 0)
+        return false;
+
+    return remap(bytes);
+}
+
+//core operation, apply the writes of one record and stamp the header
+bool PersistentBinaryHeap::redo(char *buf)
+{
+    LogRecord *record = (LogRecord *)buf;
+    int *pairs = (int *)(record + 1);
+    uint64_t max_index = record->new_size;
+    for(uint32_t i=0; i<record->count; i++){
+        max_index = max(max_index, (uint64_t)pairs[2*i] + 1);
+    }
+    if(!reserve(max_index))
+        return false;
+
+    for(uint32_t i=0; i<record->count; i++){
+        data[pairs[2*i]] = pairs[2*i+1];
+    }
+    header->version = record->seq;
+    header->size = record->new_size;
+    header->checksum = headerChecksum();
+    replayed++;
+
+    return true;
+}
+
+//replay every record of the log from the start, the header version
+//does not tell which ones reached the array. The sequence numbers must
+//follow each other. The torn tail is cut, so the next records follow
+//the good ones.
+bool PersistentBinaryHeap::recover(void)
+{
+    struct stat st;
+    if(fstat(log_fd, &st) < 0)
+        return false;
+    log_size = st.st_size;
+
+    vector<char> buf(log_size);
+    if(log_size && pread(log_fd, buf.data(), log_size, 0) != log_size)
+        return false;
+
+    long long offset = 0;
+    uint64_t last_seq = 0;
+    while(offset + (long long)sizeof(LogRecord) <= log_size){
+        LogRecord *record = (LogRecord *)(buf.data() + offset);
+        long long body = sizeof(LogRecord) + (long long)record->count * 2 * sizeof(int);
+        long long length = body + sizeof(uint64_t) + sizeof(LogFooter);
+        if(offset + length > log_size)
+            break;
+
+        //a torn or bad record, nothing after it was applied
+        uint64_t checksum;
+        LogFooter footer;
+        memcpy(&checksum, buf.data() + offset + body, sizeof(checksum));
+        memcpy(&footer, buf.data() + offset + body + sizeof(checksum), sizeof(footer));
+        if(footer.magic != LOG_MAGIC || footer.length != length ||
+           checksum != hashBytes(record, body, 14695981039346656037ull))
+            break;
+
+        //a gap, a record is missing
+        if(offset && record->seq != last_seq + 1)
+            return false;
+        if(!redo((char *)record))
+            return false;
+        last_seq = record->seq;
+        offset += length;
+    }
+
+    if(offset < log_size){
+        if(ftruncate(log_fd, offset) < 0)
+            return false;
+        log_size = offset;
+    }
+
+    return true;
+}
+
+//open or create path and path.log
+bool PersistentBinaryHeap::open(const char *path)
+{
+    close();
+    replayed = 0;
+    io_error = false;
+
+    string log_path = string(path) + ".log";
+    heap_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    log_fd = ::open(log_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if(heap_fd < 0 || log_fd < 0){
+        close();
+        return false;
+    }
+
+    struct stat st;
+    if(fstat(heap_fd, &st) < 0){
+        close();
+        return false;
+    }
+
+    //a new file
+    if(st.st_size < (off_t)sizeof(HeapHeader)){
+        size_t bytes = sizeof(HeapHeader) + INITIAL_CAPACITY*sizeof(int);
+        if(ftruncate(heap_fd, bytes) < 0 || !remap(bytes)){
+            close();
+            return false;
+        }
+        header->magic = HEAP_MAGIC;
+        header->version = 0;
+        header->size = 0;
+        header->checksum = headerChecksum();
+        return true;
+    }
+
+    if(!remap(st.st_size) || header->magic != HEAP_MAGIC){
+        close();
+        return false;
+    }
+
+    //a bad header can only be fixed by the log
+    if(!recover() || headerChecksum() != header->checksum ||
+       header->size > capacity){
+        close();
+        return false;
+    }
+
+    if(replayed){
+        checkpoint();
+    }
+
+    return true;
+}
+
+void PersistentBinaryHeap::close(void)
+{
+    if(header){
+        munmap(header, mapped);
+    }
+    if(heap_fd >= 0){
+        ::close(heap_fd);
+    }
+    if(log_fd >= 0){
+        ::close(log_fd);
+    }
+    header = NULL;
+    data = NULL;
+    mapped = 0;
+    capacity = 0;
+    heap_fd = log_fd = -1;
+}
+
+//the array is on disk, the log is not needed anymore
+void PersistentBinaryHeap::checkpoint(void)
+{
+    if(NULL == header)
+        return;
+
+    msync(header, mapped, MS_SYNC);
+    if(0 == ftruncate(log_fd, 0)){
+        log_size = 0;
+    }
+}
+
+//core operation, log the writes, then apply them and the header.
+//Return false without applying them if the record is not in the log.
+bool PersistentBinaryHeap::commit(uint64_t new_size)
+{
+    LogRecord record;
+    record.seq = header->version + 1;
+    record.new_size = new_size;
+    record.count = write_index.size();
+    record.reserved = 0;
+
+    size_t body = sizeof(LogRecord) + record.count * 2 * sizeof(int);
+    LogFooter footer = {(uint32_t)(body + sizeof(uint64_t) + sizeof(LogFooter)), LOG_MAGIC};
+    vector<char> buf(footer.length);
+    memcpy(buf.data(), &record, sizeof(record));
+    int *pairs = (int *)(buf.data() + sizeof(record));
+    for(uint32_t i=0; i<record.count; i++){
+        pairs[2*i] = write_index[i];
+        pairs[2*i+1] = write_value[i];
+    }
+    uint64_t checksum = hashBytes(buf.data(), body, 14695981039346656037ull);
+    memcpy(buf.data() + body, &checksum, sizeof(checksum));
+    memcpy(buf.data() + body + sizeof(checksum), &footer, sizeof(footer));
+
+    size_t done = 0;
+    while(done < buf.size()){
+        ssize_t n = write(log_fd, buf.data() + done, buf.size() - done);
+        if(n < 0 && EINTR == errno)
+            continue;
+        if(n <= 0)
+            break;
+        done += n;
+    }
+
+    //cut what was written, the record must not be replayed either
+    if(done < buf.size() || (durable && fdatasync(log_fd) < 0)){
+        io_error = true;
+        if(0 == ftruncate(log_fd, log_size) && durable){
+            fdatasync(log_fd);
+        }
+        return false;
+    }
+    log_size += buf.size();
+    if(crash_after_log){
+        _exit(1);
+    }
+
+    for(uint32_t i=0; i<record.count; i++){
+        data[write_index[i]] = write_value[i];
+    }
+    header->size = new_size;
+    header->version = record.seq;
+    header->checksum = headerChecksum();
+
+    if(log_size > LOG_LIMIT){
+        checkpoint();
+    }
+
+    return true;
+}
+
+//insert, the hole moves up from the new slot
+int PersistentBinaryHeap::insert(int input)
+{
+    if(NULL == header || io_error || !reserve(header->size + 1))
+        return -1;
+
+    write_index.clear();
+    write_value.clear();
+
+    int current_index = header->size;
+    while(current_index > 0){
+        int parent_index = (current_index-1)/2;
+        if(data[parent_index] <= input)
+            break;
+
+        write_index.push_back(current_index);
+        write_value.push_back(data[parent_index]);
+        current_index = parent_index;
+    }
+    write_index.push_back(current_index);
+    write_value.push_back(input);
+
+    if(!commit(header->size + 1))
+        return -1;
+
+    return current_index;
+}
+
+//extract min, the last element moves down from the root
+int PersistentBinaryHeap::extract_min()
+{
+    if(NULL == header || io_error || 0 == header->size)
+        return -1;
+
+    int result = data[0];
+    int size = header->size - 1;
+    int last = data[size];
+
+    write_index.clear();
+    write_value.clear();
+    if(size > 0){
+        int current_index = 0;
+        while(true){
+            int child = 2*current_index + 1;
+            if(child >= size)
+                break;
+            if(child+1 < size && data[child+1] < data[child]){
+                child++;
+            }
+            if(last <= data[child])
+                break;
+
+            write_index.push_back(current_index);
+            write_value.push_back(data[child]);
+            current_index = child;
+        }
+        write_index.push_back(current_index);
+        write_value.push_back(last);
+    }
+
+    if(!commit(size))
+        return -1;
+
+    return result;
+}
+
+//minimum
+int PersistentBinaryHeap::minimum()
+{
+    if(NULL == header || 0 == header->size)
+        return -1;
+
+    return data[0];
+}
+
+int PersistentBinaryHeap::size()
+{
+    if(NULL == header)
+        return 0;
+
+    return header->size;
+}
+
+//dump
+void PersistentBinaryHeap::dump(void)
+{
+    int size = this->size();
+    cout << "Dump the heap (version " << (header ? header->version : 0) << ") : ";
+    for(int i=0; i<size; i++){
+        cout << data[i] << " ";
+    }
+    cout << endl;
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//heapify in memory, the way the queue is rebuilt without the file
+void heapify(vector<int> &data)
+{
+    int size = data.size();
+    for(int i=(size-2)/2; i>=0; i--){
+        int current_index = i;
+        int value = data[i];
+        while(true){
+            int child = 2*current_index + 1;
+            if(child >= size)
+                break;
+            if(child+1 < size && data[child+1] < data[child]){
+                child++;
+            }
+            if(value <= data[child])
+                break;
+            data[current_index] = data[child];
+            current_index = child;
+        }
+        data[current_index] = value;
+    }
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    char path[] = "/tmp/persistent_heap_XXXXXX";
+    int fd = mkstemp(path);
+    if(fd < 0){
+        cout << "can not create the heap file" << endl;
+        return 1;
+    }
+    ::close(fd);
+    string log_path = string(path) + ".log";
+
+    // Insert and reopen
+    cout << "\n\tInsert, then reopen" << endl;
+    PersistentBinaryHeap myHeap;
+    myHeap.open(path);
+    for(int i=0; i<n; i++){
+        myHeap.insert(random_data[i]);
+    }
+    myHeap.dump();
+    myHeap.close();
+
+    myHeap.open(path);
+    myHeap.dump();
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    myHeap.close();
+
+    // Crash after the log record
+    cout << "\n\tCrash in the middle of insert 0" << endl;
+    pid_t pid = fork();
+    if(0 == pid){
+        PersistentBinaryHeap child;
+        child.open(path);
+        child.crash_after_log = true;
+        child.insert(0);
+        _exit(0);
+    }
+    waitpid(pid, NULL, 0);
+
+    myHeap.open(path);
+    cout << "replayed :" << myHeap.replayed << endl;
+    myHeap.dump();
+    cout << "Heap sort :";
+    while(myHeap.size()){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+    myHeap.close();
+
+    // The header loses the last operations, e.g. the page was not written
+    cout << "\n\tThe header loses three inserts, a torn record follows" << endl;
+    myHeap.open(path);
+    myHeap.checkpoint();
+    myHeap.close();
+    HeapHeader saved;
+    fd = ::open(path, O_RDWR);
+    if(fd < 0 || pread(fd, &saved, sizeof(saved), 0) != sizeof(saved)){
+        cout << "can not read the header" << endl;
+    }
+    myHeap.open(path);
+    for(int i=0; i<3; i++){
+        myHeap.insert(random_data[i]);
+    }
+    myHeap.dump();
+    myHeap.close();
+
+    int log_fd = ::open(log_path.c_str(), O_WRONLY | O_APPEND);
+    if(log_fd < 0 ||
+       pwrite(fd, &saved, sizeof(saved), 0) != sizeof(saved) ||
+       write(log_fd, &saved, sizeof(saved)) != sizeof(saved)){
+        cout << "can not write the files" << endl;
+    }
+    ::close(fd);
+    ::close(log_fd);
+
+    myHeap.open(path);
+    cout << "replayed :" << myHeap.replayed << endl;
+    myHeap.dump();
+    myHeap.close();
+
+    // The header is written but the array is not, e.g. a power loss
+    cout << "\n\tThe array loses three inserts, the header has them" << endl;
+    struct stat st;
+    vector<char> array;
+    fd = ::open(path, O_RDWR);
+    if(fd < 0 || fstat(fd, &st) < 0){
+        cout << "can not read the array" << endl;
+    }else{
+        array.resize(st.st_size - sizeof(HeapHeader));
+        if(pread(fd, array.data(), array.size(), sizeof(HeapHeader)) != (ssize_t)array.size()){
+            cout << "can not read the array" << endl;
+        }
+    }
+    myHeap.open(path);
+    for(int i=0; i<3; i++){
+        myHeap.insert(random_data[i]);
+    }
+    myHeap.dump();
+    myHeap.close();
+
+    if(pwrite(fd, array.data(), array.size(), sizeof(HeapHeader)) != (ssize_t)array.size()){
+        cout << "can not write the array" << endl;
+    }
+    ::close(fd);
+
+    myHeap.open(path);
+    cout << "replayed :" << myHeap.replayed << endl;
+    myHeap.dump();
+    cout << "Heap sort :";
+    while(myHeap.size()){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+    myHeap.close();
+
+    // Benchmark
+    cout << "\n\tBenchmark insert and extract_min" << endl;
+    unlink(path);
+    unlink(log_path.c_str());
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    myHeap.open(path);
+    for(int i=0; i<bench_n; i++){
+        myHeap.insert(bench_data[i]);
+    }
+    for(int i=0; i<bench_n/2; i++){
+        checksum += myHeap.extract_min();
+    }
+    myHeap.close();
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by persistent heap: "
+         << duration.count() << " microseconds" << endl;
+
+    start = high_resolution_clock::now();
+    myHeap.open(path);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by reopen with " << myHeap.size() << " elements: "
+         << duration.count() << " microseconds" << endl;
+    checksum += myHeap.minimum();
+    myHeap.close();
+
+    //the restart without the file, reload and heapify
+    start = high_resolution_clock::now();
+    vector<int> reload(bench_data, bench_data + bench_n/2);
+    heapify(reload);
+    stop = high_resolution_clock::now();
+    duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by reload and heapify: "
+         << duration.count() << " microseconds" << endl;
+    checksum += reload[0];
+    cout << "checksum :" << checksum << endl;
+
+    unlink(path);
+    unlink(log_path.c_str());
+
+    return 0;
+}
+/*==============================================================*/
@@ -0,0 +1,395 @@
+/*****************************************************************
+Name    :radix_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 opt-in operation stats
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "heap_stats.h"
+#define DEBUG (1)
+#define SCALE (20)
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#define BUCKETS (33)
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//Doubly linked in its bucket, so decrease-key and delete are O(1)
+struct Node{
+    int data;
+    Node *prev=NULL;
+    Node *next=NULL;
+    int bucket=0;
+};
+
+//Monotone radix heap for non-negative keys
+//Bucket 0 holds the keys equal to the last extracted minimum, bucket i
+//holds the keys whose highest bit differing from it is bit i-1.
+//The keys never go below the last minimum, insert and decrease_key
+//return NULL for such a key and leave the heap as it is.
+class RadixHeap{
+    Node *bucket[BUCKETS];
+
+    //bit i is set if bucket i is not empty
+    uint64_t nonempty=0;
+
+    //core operation
+    int bucketOf(int key);
+    void link(Node *input);
+    void unlink(Node *input);
+    int refill(void);
+public:
+    int last=0;
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    RadixHeap();
+    RadixHeap(int *arr, int size);
+    ~RadixHeap();
+    Node *insert(int input);
+    int extract_min();
+    int minimum();
+
+    //decrease-key and delete
+    Node *decrease_key(Node *input, int new_val);
+    void delete_key(Node *input);
+
+    //find
+    Node *find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+RadixHeap::RadixHeap()
+{
+    for(int i=0; i<BUCKETS; i++){
+        bucket[i] = NULL;
+    }
+}
+
+//Initialize
+RadixHeap::RadixHeap(int *arr, int size) : RadixHeap()
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+RadixHeap::~RadixHeap()
+{
+    for(int i=0; i<BUCKETS; i++){
+        Node *current = bucket[i];
+        while(current){
+            Node *next_node = current->next;
+            delete current;
+            current = next_node;
+        }
+    }
+}
+
+//the highest differing bit against the last minimum
+int RadixHeap::bucketOf(int key)
+{
+    uint32_t diff = (uint32_t)key ^ (uint32_t)last;
+    if(0 == diff)
+        return 0;
+
+    return 32 - __builtin_clz(diff);
+}
+
+//core operation
+void RadixHeap::link(Node *input)
+{
+    int i = bucketOf(input->data);
+    input->bucket = i;
+    input->prev = NULL;
+    input->next = bucket[i];
+    if(bucket[i]){
+        bucket[i]->prev = input;
+    }
+    bucket[i] = input;
+    nonempty |= (uint64_t)1 << i;
+}
+
+//core operation
+void RadixHeap::unlink(Node *input)
+{
+    int i = input->bucket;
+    if(input->prev){
+        input->prev->next = input->next;
+    }else{
+        bucket[i] = input->next;
+    }
+    if(input->next){
+        input->next->prev = input->prev;
+    }
+    if(NULL == bucket[i]){
+        nonempty &= ~((uint64_t)1 << i);
+    }
+}
+
+//core operation
+//if bucket 0 is empty, the min of the first non-empty bucket becomes the
+//last minimum and that bucket is spread over the lower ones,
+//return how many keys moved
+int RadixHeap::refill(void)
+{
+    if(bucket[0] || 0 == nonempty)
+        return 0;
+
+    int i = __builtin_ctzll(nonempty);
+    Node *current = bucket[i];
+    int min_value = current->data;
+    for(current=current->next; current; current=current->next){
+        if(current->data < min_value){
+            min_value = current->data;
+        }
+    }
+    last = min_value;
+
+    current = bucket[i];
+    bucket[i] = NULL;
+    nonempty &= ~((uint64_t)1 << i);
+    int moved = 0;
+    while(current){
+        Node *next_node = current->next;
+        link(current);
+        current = next_node;
+        moved++;
+    }
+
+    return moved;
+}
+
+//insert
+Node *RadixHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    if(input < last)
+        return NULL;
+
+    Node *newNode = new Node();
+    newNode->data = input;
+    link(newNode);
+    number++;
+
+    return newNode;
+}
+
+//extract_min
+int RadixHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(0 == number)
+        return -1;
+
+    int moved = refill();
+    HEAP_STATS_RECORD(STATS_REDISTRIBUTE, moved);
+    Node *target = bucket[0];
+    int result = target->data;
+    unlink(target);
+
+    delete target;
+    number--;
+
+    return result;
+}
+
+//minimum
+int RadixHeap::minimum()
+{
+    if(0 == number)
+        return -1;
+
+    refill();
+    return last;
+}
+
+//decrease key, move the node to the bucket of the new key
+Node *RadixHeap::decrease_key(Node *input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NULL == input || new_val < last)
+        return NULL;
+    if(input->data <= new_val)
+        return input;
+
+    unlink(input);
+    input->data = new_val;
+    link(input);
+
+    return input;
+}
+
+//delete
+void RadixHeap::delete_key(Node *input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NULL == input)
+        return;
+
+    unlink(input);
+    delete input;
+    number--;
+}
+
+//find
+Node *RadixHeap::find(int key)
+{
+    if(key < last)
+        return NULL;
+
+    for(Node *current=bucket[bucketOf(key)]; current; current=current->next){
+        if(current->data == key)
+            return current;
+    }
+
+    return NULL;
+}
+
+//dump elements
+void RadixHeap::dump(void)
+{
+    cout << "Dump the heap, last :" << last << endl;
+    for(int i=0; i<BUCKETS; i++){
+        if(NULL == bucket[i])
+            continue;
+
+        cout << "B(" << i << ") =";
+        for(Node *current=bucket[i]; current; current=current->next){
+            cout << " " << current->data;
+        }
+        cout << endl;
+    }
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Initialize from the array
+    cout << "\n\tInitialize from the array" << endl;
+    RadixHeap myHeap(random_data, n);
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Insert the new element
+    cout << "\n\tInsert the new element" << endl;
+    Node *temp = myHeap.insert(8);
+    myHeap.insert(15);
+    myHeap.insert(4);
+    myHeap.dump();
+
+    // Test minimum and extract min
+    cout << "\n\tTest minimum and extract min" << endl;
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "insert 1 below the last minimum :"
+         << (myHeap.insert(1) ? "done" : "rejected") << endl;
+
+    // Test decrease-key and delete
+    cout << "\n\tTest decrease-key and delete" << endl;
+    int decrease_value = 17;
+    Node *decrease_node = myHeap.decrease_key(myHeap.find(17), 5);
+    cout << "decrease-key from " << decrease_value << " to "
+        << decrease_node->data << endl;
+    myHeap.delete_key(myHeap.find(6));
+    myHeap.delete_key(temp);
+    cout << "After delete" << endl;
+    myHeap.dump();
+
+    // Find the value
+    int find_value = 9;
+    cout << "\n\tFind the value : " << find_value << endl;
+    Node *find_node = myHeap.find(find_value);
+    cout << "Find Node :";
+    if(NULL != find_node){
+        cout << find_node->data << endl;
+    }else{
+        cout << "NULL" << endl;
+    }
+
+    // Heap sort
+    cout << "\n\tHeap sort" << endl;
+    cout << "Heap sort :";
+    while(myHeap.number){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Benchmark monotone workload
+    cout << "\n\tBenchmark monotone workload" << endl;
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    RadixHeap benchHeap;
+    for(int i=0; i<bench_n; i++){
+        benchHeap.insert(bench_data[i]);
+    }
+    for(int i=0; i<bench_n; i++){
+        int key = benchHeap.extract_min();
+        checksum += key;
+        if(i & 1){
+            benchHeap.insert(key + bench_data[i] % 1000);
+        }
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by insert and extract_min: "
+         << duration.count() << " microseconds" << endl;
+    cout << "checksum :" << checksum << endl;
+
+    return 0;
+}
+/*==============================================================*/
@@ -0,0 +1,503 @@
+/*****************************************************************
+Name    :rank_pairing_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 delete does not count an extract_min too
+    20261019 opt-in operation stats
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include "heap_stats.h"
+#define DEBUG (1)
+#define SCALE (20)
+using namespace std;
+
+/*==============================================================*/
+//Global area
+//Half-ordered binary tree, type-1 rank rule
+//For a root, next is the root list and left is its only child.
+//For the others, left and next are the left and right children.
+struct Node{
+    int data;
+    Node *left=NULL;
+    Node *next=NULL;
+    Node *parent=NULL;
+
+    //a root has the rank of its left child plus one
+    int rank=0;
+};
+
+class RankPairingHeap{
+    //core operation
+    Node *link(Node *n1, Node *n2);
+    void addRoot(Node *input);
+    int cut(Node *input);
+    int removeMin(void);
+
+    //one-pass linking
+    vector<Node*> bucket;
+    Node *result;
+    void onePass(Node *input);
+
+    //preorder traversal
+    void preorderTraversal(Node *current);
+public:
+    Node *minNode=NULL;
+    int number=0;
+#ifdef HEAP_STATS
+    HeapStats stats;
+#endif
+
+    //five operations
+    RankPairingHeap();
+    RankPairingHeap(int *arr, int size);
+    Node *insert(int input);
+    int extract_min();
+    int minimum();
+    void merge(RankPairingHeap &rph);
+
+    //decrease-key and delete
+    Node *decrease_key(Node *input, int new_val);
+    void delete_key(Node *input);
+
+    //find
+    Node *find(int key);
+
+    //dump elements
+    void dump(void);
+};
+
+RankPairingHeap::RankPairingHeap()
+{
+
+}
+
+//core operation
+//link two half-trees, the greater root becomes the left child of the
+//less one and its old left child becomes the right child.
+Node *RankPairingHeap::link(Node *n1, Node *n2)
+{
+    Node *less = (n2->data < n1->data)? n2 : n1;
+    Node *greater = (n1 == less)? n2 : n1;
+
+    greater->next = less->left;
+    if(less->left){
+        less->left->parent = greater;
+    }
+    less->left = greater;
+    greater->parent = less;
+    less->rank = greater->rank + 1;
+
+    return less;
+}
+
+//add a half-tree after the min node of the circular root list
+void RankPairingHeap::addRoot(Node *input)
+{
+    input->parent = NULL;
+    if(NULL == minNode){
+        input->next = input;
+        minNode = input;
+        return;
+    }
+
+    input->next = minNode->next;
+    minNode->next = input;
+    if(input->data < minNode->data){
+        minNode = input;
+    }
+}
+
+//cut the node with its left subtree into the root list, its right
+//subtree takes its place, then reduce the ranks of the ancestors,
+//return how many of them changed
+int RankPairingHeap::cut(Node *input)
+{
+    Node *parent = input->parent;
+    Node *right = input->next;
+
+    if(parent->left == input){
+        parent->left = right;
+    }else{
+        parent->next = right;
+    }
+    if(right){
+        right->parent = parent;
+    }
+
+    input->rank = input->left ? input->left->rank + 1 : 0;
+    addRoot(input);
+
+    //rank reduction
+    int fixed = 0;
+    Node *current = parent;
+    while(current){
+        if(NULL == current->parent){
+            current->rank = current->left ? current->left->rank + 1 : 0;
+            fixed++;
+            break;
+        }
+
+        int r1 = current->left ? current->left->rank : -1;
+        int r2 = current->next ? current->next->rank : -1;
+        int k = (r1 > r2) ? r1 : r2;
+        if(r1 - r2 <= 1 && r2 - r1 <= 1){
+            k++;
+        }
+
+        if(k >= current->rank)
+            break;
+
+        current->rank = k;
+        current = current->parent;
+        fixed++;
+    }
+
+    return fixed;
+}
+
+//one-pass linking, link a root with the one of the same rank seen
+//before it, otherwise park it in the bucket
+void RankPairingHeap::onePass(Node *input)
+{
+    int rank = input->rank;
+    if(rank >= (int)bucket.size()){
+        bucket.resize(rank+1, NULL);
+    }
+
+    if(NULL == bucket[rank]){
+        bucket[rank] = input;
+        return;
+    }
+
+    Node *linked = link(bucket[rank], input);
+    bucket[rank] = NULL;
+    linked->next = result;
+    result = linked;
+}
+
+//Initialize
+RankPairingHeap::RankPairingHeap(int *arr, int size)
+{
+    for(int i=0; i<size; i++){
+        insert(arr[i]);
+    }
+}
+
+//insert
+Node *RankPairingHeap::insert(int input)
+{
+    HEAP_STATS_OP(STATS_INSERT);
+    Node *newNode = new Node();
+    newNode->data = input;
+    addRoot(newNode);
+    number++;
+
+    return newNode;
+}
+
+//core operation, remove the min node, shared by extract_min and delete
+int RankPairingHeap::removeMin(void)
+{
+    Node *target = minNode;
+    int data = target->data;
+    result = NULL;
+
+    //the other roots
+    int subtrees = 0;
+    Node *current = target->next;
+    while(current != target){
+        Node *next_node = current->next;
+        onePass(current);
+        current = next_node;
+        subtrees++;
+    }
+
+    //disassemble the right spine of the left child into half-trees
+    current = target->left;
+    while(current){
+        Node *next_node = current->next;
+        current->next = NULL;
+        current->parent = NULL;
+        current->rank = current->left ? current->left->rank + 1 : 0;
+        onePass(current);
+        current = next_node;
+        subtrees++;
+    }
+    HEAP_STATS_RECORD(STATS_ROOT_LIST, subtrees);
+
+    //collect the unlinked roots
+    for(int i=0; i<(int)bucket.size(); i++){
+        if(bucket[i]){
+            bucket[i]->next = result;
+            result = bucket[i];
+            bucket[i] = NULL;
+        }
+    }
+
+    //reconstruct the root list and find the min node
+    minNode = NULL;
+    while(result){
+        Node *next_node = result->next;
+        addRoot(result);
+        result = next_node;
+    }
+
+    delete target;
+    number--;
+
+    return data;
+}
+
+//extract_min
+int RankPairingHeap::extract_min()
+{
+    HEAP_STATS_OP(STATS_EXTRACT_MIN);
+    if(NULL == minNode)
+        return -1;
+
+    return removeMin();
+}
+
+//minimum
+int RankPairingHeap::minimum()
+{
+    if(NULL == minNode)
+        return -1;
+
+    return minNode->data;
+}
+
+//merge
+void RankPairingHeap::merge(RankPairingHeap &rph)
+{
+    HEAP_STATS_OP(STATS_MERGE);
+    if(NULL == rph.minNode)
+        return;
+
+    if(NULL == minNode){
+        minNode = rph.minNode;
+    }else{
+        //splice the two circular lists
+        Node *temp = minNode->next;
+        minNode->next = rph.minNode->next;
+        rph.minNode->next = temp;
+        if(rph.minNode->data < minNode->data){
+            minNode = rph.minNode;
+        }
+    }
+    number += rph.number;
+
+    rph.minNode = NULL;
+    rph.number = 0;
+}
+
+//decrease key
+Node *RankPairingHeap::decrease_key(Node *input, int new_val)
+{
+    HEAP_STATS_OP(STATS_DECREASE_KEY);
+    if(NULL == input)
+        return NULL;
+    if(input->data <= new_val)
+        return input;
+
+    input->data = new_val;
+    if(NULL == input->parent){
+        if(new_val < minNode->data){
+            minNode = input;
+        }
+        return input;
+    }
+
+    int fixed = cut(input);
+    HEAP_STATS_RECORD(STATS_RANK_FIX, fixed);
+
+    return input;
+}
+
+//delete, make it a root and extract it as the min
+void RankPairingHeap::delete_key(Node *input)
+{
+    HEAP_STATS_OP(STATS_DELETE);
+    if(NULL == input)
+        return;
+
+    if(input->parent){
+        cut(input);
+    }
+    minNode = input;
+    removeMin();
+}
+
+//find
+Node *RankPairingHeap::find(int key)
+{
+    if(NULL == minNode)
+        return NULL;
+
+    vector<Node*> stack;
+    Node *current = minNode;
+    do{
+        if(current->data == key)
+            return current;
+        if(current->left) stack.push_back(current->left);
+
+        while(!stack.empty()){
+            Node *temp = stack.back();
+            stack.pop_back();
+
+            if(temp->data == key)
+                return temp;
+            if(temp->next) stack.push_back(temp->next);
+            if(temp->left) stack.push_back(temp->left);
+        }
+
+        current = current->next;
+    }while(current != minNode);
+
+    return NULL;
+}
+
+//half-tree preorder traversal
+void RankPairingHeap::preorderTraversal(Node *current)
+{
+    if(NULL == current){
+        return;
+    }
+
+    cout << " " << current->data;
+    preorderTraversal(current->left);
+    preorderTraversal(current->next);
+}
+
+//dump elements
+void RankPairingHeap::dump(void)
+{
+    if(NULL == minNode)
+        return;
+
+    cout << "Dump the heap : " << endl;
+    Node *current = minNode;
+    do{
+        cout << "R(" << current->rank << ") = " << current->data;
+        preorderTraversal(current->left);
+        cout << endl;
+
+        current = current->next;
+    }while(current != minNode);
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Initialize from the array
+    cout << "\n\tInitialize from the array" << endl;
+    RankPairingHeap myHeap(random_data, n);
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Insert the new element
+    cout << "\n\tInsert the new element" << endl;
+    Node *temp = myHeap.insert(8);
+    myHeap.insert(15);
+    myHeap.insert(4);
+
+    // Test minimum and extract min
+    cout << "\n\tTest minimum and extract min" << endl;
+    cout << "minimum :" << myHeap.minimum() << endl;
+    cout << "extract_min :" << myHeap.extract_min() << endl;
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Test decrease-key and delete
+    cout << "\n\tTest decrease-key and delete" << endl;
+    int decrease_value = 7;
+    Node *decrease_node = myHeap.decrease_key(myHeap.find(7), 1);
+    cout << "decrease-key from " << decrease_value << " to "
+        << decrease_node->data << endl;
+    myHeap.dump();
+
+    cout << "\nBefore delete" << endl;
+    myHeap.dump();
+
+    myHeap.delete_key(myHeap.find(6));
+    myHeap.delete_key(temp);
+
+    cout << "After delete" << endl;
+    myHeap.dump();
+
+    // Find the value
+    int find_value = 9;
+    cout << "\n\tFind the value : " << find_value << endl;
+    Node *find_node = myHeap.find(find_value);
+    cout << "Find Node :";
+    if(NULL != find_node){
+        cout << find_node->data << endl;
+    }else{
+        cout << "NULL" << endl;
+    }
+
+    // Merge the two heap
+    cout << "\n\tMerge the two heap" << endl;
+    n=13;
+    int *random_data2 = random_case(50, n);
+#if DEBUG
+    cout << "Generate Data2 :";
+    for(int i=0; i<n; i++){
+        cout << random_data2[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    RankPairingHeap myHeap2(random_data2, n);
+    myHeap.merge(myHeap2);
+    myHeap.dump();
+
+    // Heap sort
+    cout << "\n\tHeap sort" << endl;
+    cout << "Heap sort :";
+    while(myHeap.minNode){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    return 0;
+}
+/*==============================================================*/
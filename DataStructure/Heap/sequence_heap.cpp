@@ -0,0 +1,665 @@
+/*****************************************************************
+Name    :sequence_heap
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <string>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#ifndef INSERT_HEAP_SIZE
+#define INSERT_HEAP_SIZE (1024)     //m, the insertion heap and every buffer
+#endif
+#ifndef MERGE_WAYS
+#define MERGE_WAYS (64)             //k, the runs of a group
+#endif
+#ifndef MEMORY_GROUPS
+#define MEMORY_GROUPS (3)           //the deeper groups are on disk
+#endif
+#ifndef DISK_BLOCK
+#define DISK_BLOCK (1<<20)          //bytes of one read or write on disk
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The baseline in the benchmark, see binary_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+//A sorted run, read from the front. A run on disk is in a temporary
+//file that is already unlinked, it is read DISK_BLOCK bytes at a time.
+class Run{
+    vector<int> block;
+    size_t pos=0;
+    int fd=-1;
+    long long offset=0;     //next read in the file, in bytes
+    long long remain=0;     //ints in the file after the block
+
+    void refill(void);
+public:
+    bool io_error=false;
+
+    Run(vector<int> &data);
+    Run(int fd, long long count);
+    ~Run();
+    bool empty(void);
+    int front(void);
+    void pop(void);
+    long long left(void);
+};
+
+//in memory, the data is moved into the run
+Run::Run(vector<int> &data)
+{
+    block.swap(data);
+}
+
+//on disk, the run takes the file
+Run::Run(int fd, long long count) : fd(fd), remain(count)
+{
+    refill();
+}
+
+Run::~Run()
+{
+    if(fd >= 0)
+        close(fd);
+}
+
+//read the next block, a failed read ends the run
+void Run::refill(void)
+{
+    long long count = min(remain, (long long)(DISK_BLOCK / sizeof(int)));
+    block.resize(count);
+    pos = 0;
+
+    size_t bytes = count * sizeof(int);
+    size_t done = 0;
+    while(done < bytes){
+        ssize_t got = pread(fd, (char *)block.data() + done, bytes - done, offset + done);
+        if(got <= 0){
+            io_error = true;
+            block.clear();
+            remain = 0;
+            return;
+        }
+        done += got;
+    }
+    offset += bytes;
+    remain -= count;
+}
+
+bool Run::empty(void)
+{
+    return pos == block.size();
+}
+
+int Run::front(void)
+{
+    return block[pos];
+}
+
+void Run::pop(void)
+{
+    pos++;
+    if(pos == block.size()){
+        if(remain){
+            refill();
+        }else{
+            vector<int>().swap(block);
+            pos = 0;
+        }
+    }
+}
+
+long long Run::left(void)
+{
+    return (block.size() - pos) + remain;
+}
+
+//Loser tree over k runs
+//tree[0] is the run with the smallest front, every inner node keeps the
+//loser of the game played there. An empty run loses to everything, so
+//the tree is empty when the winner is.
+class LoserTree{
+    vector<Run*> source;
+    vector<int> tree;
+    int k=0;    //leaves, a power of two
+
+    bool less(int a, int b);
+    int play(int node);
+public:
+    void init(vector<Run*> &runs);
+    bool empty(void);
+    int pop(void);
+};
+
+//the padded leaves and the empty runs are last
+bool LoserTree::less(int a, int b)
+{
+    if(a >= (int)source.size() || source[a]->empty())
+        return false;
+    if(b >= (int)source.size() || source[b]->empty())
+        return true;
+
+    return source[a]->front() < source[b]->front();
+}
+
+//the winner of the subtree, its losers are kept on the way
+int LoserTree::play(int node)
+{
+    if(node >= k)
+        return node - k;
+
+    int w1 = play(2*node);
+    int w2 = play(2*node+1);
+    if(less(w2, w1)){
+        tree[node] = w1;
+        return w2;
+    }
+    tree[node] = w2;
+    return w1;
+}
+
+void LoserTree::init(vector<Run*> &runs)
+{
+    source = runs;
+    k = 1;
+    while(k < (int)source.size()){
+        k *= 2;
+    }
+    tree.assign(k, 0);
+    tree[0] = play(1);
+}
+
+bool LoserTree::empty(void)
+{
+    return source.empty() || source[tree[0]]->empty();
+}
+
+//take the smallest front, then replay the games on the path of its leaf
+int LoserTree::pop(void)
+{
+    int winner = tree[0];
+    int result = source[winner]->front();
+    source[winner]->pop();
+
+    for(int node=(winner+k)/2; node>=1; node/=2){
+        if(less(tree[node], winner)){
+            int temp = tree[node];
+            tree[node] = winner;
+            winner = temp;
+        }
+    }
+    tree[0] = winner;
+
+    return result;
+}
+
+//A group of up to k runs, merged by its loser tree into the buffer.
+//The buffer keeps the smallest elements of the group.
+struct Group{
+    vector<Run*> runs;
+    LoserTree tree;
+    vector<int> buffer;
+    size_t head=0;
+};
+
+//Sequence heap, Sanders 2000
+//Inserts go to a small insertion heap. A full insertion heap is sorted
+//into a run of group 0. A group holds up to k runs, when it is full
+//they are merged into one run of the next group, so the runs of group
+//g are about m*k^g long. Every group has a buffer with its smallest
+//elements, and the deletion buffer the smallest of all the buffers.
+//The min is in the insertion heap or the deletion buffer.
+//  deletion buffer <= every group buffer
+//  group buffer g <= every run of group g
+//Groups from memory_groups on write their runs to disk, a merge reads
+//each of its runs a block at a time, so all the I/O is sequential.
+class SequenceHeap{
+    vector<int> insert_heap;    //min heap with greater<int>
+    vector<int> deletion;
+    size_t deletion_head=0;
+    vector<Group> groups;
+    int memory_groups;
+    string dir;
+    long long number=0;
+
+    //core operation
+    void spill(void);
+    void makeSpace(int g);
+    Run *mergeRuns(vector<Run*> &runs, bool disk);
+    void dropEmpty(int g);
+    void refillGroup(int g);
+    void refillDeletion(void);
+public:
+    bool io_error=false;
+
+    SequenceHeap(int memory_groups=MEMORY_GROUPS, const char *dir="/tmp");
+    ~SequenceHeap();
+    void insert(int input);
+    int extract_min();
+    int minimum();
+    long long size();
+
+    //dump elements of the buffers, and the size of the groups
+    void dump(void);
+    void dump_groups(void);
+};
+
+SequenceHeap::SequenceHeap(int memory_groups, const char *dir)
+    : memory_groups(memory_groups), dir(dir)
+{
+    insert_heap.reserve(INSERT_HEAP_SIZE);
+}
+
+SequenceHeap::~SequenceHeap()
+{
+    for(int g=0; g<(int)groups.size(); g++){
+        for(int i=0; i<(int)groups[g].runs.size(); i++){
+            delete groups[g].runs[i];
+        }
+    }
+}
+
+//merge the runs into a new one, on disk it is written block by block
+Run *SequenceHeap::mergeRuns(vector<Run*> &runs, bool disk)
+{
+    LoserTree tree;
+    tree.init(runs);
+
+    vector<int> out;
+    if(!disk){
+        long long total = 0;
+        for(int i=0; i<(int)runs.size(); i++){
+            total += runs[i]->left();
+        }
+        out.reserve(total);
+        while(!tree.empty()){
+            out.push_back(tree.pop());
+        }
+        return new Run(out);
+    }
+
+    string path = dir + "/sequence_heap_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if(fd < 0){
+        io_error = true;
+        fd = open("/dev/null", O_RDONLY);
+    }else{
+        unlink(path.c_str());
+    }
+
+    long long count = 0;
+    size_t block = DISK_BLOCK / sizeof(int);
+    out.reserve(block);
+    while(!tree.empty()){
+        out.push_back(tree.pop());
+        if(out.size() == block || tree.empty()){
+            size_t bytes = out.size() * sizeof(int);
+            if(write(fd, out.data(), bytes) != (ssize_t)bytes){
+                io_error = true;
+            }
+            count += out.size();
+            out.clear();
+        }
+    }
+
+    return new Run(fd, count);
+}
+
+//forget the runs the loser tree has used up
+void SequenceHeap::dropEmpty(int g)
+{
+    Group &group = groups[g];
+    int kept = 0;
+    for(int i=0; i<(int)group.runs.size(); i++){
+        if(group.runs[i]->io_error)
+            io_error = true;
+
+        if(group.runs[i]->left()){
+            group.runs[kept++] = group.runs[i];
+        }else{
+            delete group.runs[i];
+        }
+    }
+    if(kept < (int)group.runs.size()){
+        group.runs.resize(kept);
+        group.tree.init(group.runs);
+    }
+}
+
+//Make room for one more run in group g. A full group is merged into
+//one run of group g+1 with the buffer of g+1, which is then empty, so
+//the buffer is still no greater than the runs behind it. The buffer
+//of g keeps its elements.
+void SequenceHeap::makeSpace(int g)
+{
+    if(g == (int)groups.size()){
+        groups.push_back(Group());
+    }
+    dropEmpty(g);
+    if((int)groups[g].runs.size() < MERGE_WAYS)
+        return;
+
+    makeSpace(g+1);
+    Group &group = groups[g];
+    Group &next = groups[g+1];
+
+    vector<Run*> sources = group.runs;
+    vector<int> rest(next.buffer.begin() + next.head, next.buffer.end());
+    Run *buffer_run = new Run(rest);
+    sources.push_back(buffer_run);
+    Run *merged = mergeRuns(sources, g+1 >= memory_groups);
+
+    for(int i=0; i<(int)sources.size(); i++){
+        delete sources[i];
+    }
+    group.runs.clear();
+    group.tree.init(group.runs);
+    next.buffer.clear();
+    next.head = 0;
+
+    next.runs.push_back(merged);
+    next.tree.init(next.runs);
+}
+
+//Sort the full insertion heap into a run of group 0. The run may be
+//smaller than the buffers, so it is merged with the deletion buffer and
+//the buffer of group 0 first, the smallest elements refill the two
+//buffers to their old sizes and the rest is the run.
+void SequenceHeap::spill(void)
+{
+    makeSpace(0);
+    Group &group = groups[0];
+
+    vector<int> run(insert_heap);
+    insert_heap.clear();
+    sort(run.begin(), run.end());
+
+    size_t d = deletion.size() - deletion_head;
+    size_t b = group.buffer.size() - group.head;
+    vector<int> all(run.size() + d + b);
+    vector<int> buffers(d + b);
+    merge(deletion.begin() + deletion_head, deletion.end(),
+        group.buffer.begin() + group.head, group.buffer.end(), buffers.begin());
+    merge(buffers.begin(), buffers.end(), run.begin(), run.end(), all.begin());
+
+    deletion.assign(all.begin(), all.begin() + d);
+    deletion_head = 0;
+    group.buffer.assign(all.begin() + d, all.begin() + d + b);
+    group.head = 0;
+    run.assign(all.begin() + d + b, all.end());
+
+    group.runs.push_back(new Run(run));
+    group.tree.init(group.runs);
+}
+
+//refill an empty group buffer from its loser tree
+void SequenceHeap::refillGroup(int g)
+{
+    Group &group = groups[g];
+    group.buffer.clear();
+    group.head = 0;
+    while(!group.tree.empty() && group.buffer.size() < INSERT_HEAP_SIZE){
+        group.buffer.push_back(group.tree.pop());
+    }
+}
+
+//refill the empty deletion buffer with the smallest of the group
+//buffers, a group buffer that runs out is refilled on the way
+void SequenceHeap::refillDeletion(void)
+{
+    deletion.clear();
+    deletion_head = 0;
+    while(deletion.size() < INSERT_HEAP_SIZE){
+        int best = -1;
+        for(int g=0; g<(int)groups.size(); g++){
+            Group &group = groups[g];
+            if(group.head == group.buffer.size()){
+                refillGroup(g);
+                if(group.buffer.empty())
+                    continue;
+            }
+            if(best < 0 || group.buffer[group.head] < groups[best].buffer[groups[best].head]){
+                best = g;
+            }
+        }
+        if(best < 0)
+            break;
+
+        deletion.push_back(groups[best].buffer[groups[best].head++]);
+    }
+}
+
+//insert
+void SequenceHeap::insert(int input)
+{
+    insert_heap.push_back(input);
+    push_heap(insert_heap.begin(), insert_heap.end(), greater<int>());
+    number++;
+
+    if(INSERT_HEAP_SIZE == insert_heap.size()){
+        spill();
+    }
+}
+
+//extract min
+int SequenceHeap::extract_min()
+{
+    if(0 == number)
+        return -1;
+
+    if(deletion_head == deletion.size()){
+        refillDeletion();
+    }
+    number--;
+
+    if(deletion_head < deletion.size() &&
+        (insert_heap.empty() || deletion[deletion_head] <= insert_heap.front()))
+    {
+        return deletion[deletion_head++];
+    }
+
+    pop_heap(insert_heap.begin(), insert_heap.end(), greater<int>());
+    int result = insert_heap.back();
+    insert_heap.pop_back();
+
+    return result;
+}
+
+//minimum
+int SequenceHeap::minimum()
+{
+    if(0 == number)
+        return -1;
+
+    if(deletion_head == deletion.size()){
+        refillDeletion();
+    }
+    if(deletion_head < deletion.size() &&
+        (insert_heap.empty() || deletion[deletion_head] <= insert_heap.front()))
+    {
+        return deletion[deletion_head];
+    }
+
+    return insert_heap.front();
+}
+
+long long SequenceHeap::size()
+{
+    return number;
+}
+
+//dump elements of the buffers
+void SequenceHeap::dump(void)
+{
+    cout << "insertion heap :";
+    for(int i=0; i<(int)insert_heap.size(); i++){
+        cout << insert_heap[i] << " ";
+    }
+    cout << endl;
+
+    cout << "deletion buffer :";
+    for(size_t i=deletion_head; i<deletion.size(); i++){
+        cout << deletion[i] << " ";
+    }
+    cout << endl;
+    dump_groups();
+}
+
+//dump the size of every group
+void SequenceHeap::dump_groups(void)
+{
+    for(int g=0; g<(int)groups.size(); g++){
+        long long count = 0;
+        for(int i=0; i<(int)groups[g].runs.size(); i++){
+            count += groups[g].runs[i]->left();
+        }
+        cout << "group " << g << (g >= memory_groups ? " on disk" : "")
+             << " :buffer " << groups[g].buffer.size() - groups[g].head
+             << ", runs " << groups[g].runs.size()
+             << ", elements " << count << endl;
+    }
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//n inserts, then rounds of extract_min and insert, then drain
+template<class Heap>
+void bench(const char *name, Heap &heap, int *arr, int n)
+{
+    long long checksum = 0;
+    auto start = high_resolution_clock::now();
+    for(int i=0; i<n; i++){
+        heap.insert(arr[i]);
+    }
+    for(int i=0; i<n/2; i++){
+        checksum += heap.extract_min();
+        heap.insert(arr[i] + n);
+    }
+    for(int i=0; i<n; i++){
+        checksum += heap.extract_min();
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << name << ": "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Insert the elements
+    cout << "\n\tInsert the elements" << endl;
+    SequenceHeap myHeap;
+    for(int i=0; i<n; i++){
+        myHeap.insert(random_data[i]);
+    }
+    myHeap.dump();
+    cout << "minimum :" << myHeap.minimum() << endl;
+
+    // Heap sort
+    cout << "\n\tHeap sort :";
+    while(myHeap.size()){
+        cout << myHeap.extract_min() << " ";
+    }
+    cout << endl;
+
+    // Groups in memory and on disk
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+    cout << "\n\tInsert " << bench_n << " elements, group 1 on disk" << endl;
+    {
+        SequenceHeap diskHeap(1);
+        for(int i=0; i<bench_n; i++){
+            diskHeap.insert(bench_data[i]);
+        }
+        diskHeap.dump_groups();
+        cout << "extract_min :" << diskHeap.extract_min() << endl;
+        diskHeap.dump_groups();
+    }
+
+    // Benchmark
+    cout << "\n\tBenchmark, " << bench_n << " inserts, hold and drain" << endl;
+    {
+        binary::BinaryHeap binaryHeap(NULL, 0);
+        bench("BinaryHeap", binaryHeap, bench_data, bench_n);
+    }
+    {
+        SequenceHeap sequenceHeap;
+        bench("SequenceHeap", sequenceHeap, bench_data, bench_n);
+    }
+    {
+        SequenceHeap diskHeap(1);
+        bench("SequenceHeap, group 1 on disk", diskHeap, bench_data, bench_n);
+        if(diskHeap.io_error)
+            cout << "I/O error" << endl;
+    }
+
+    return 0;
+}
+/*==============================================================*/
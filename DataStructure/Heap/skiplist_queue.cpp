@@ -0,0 +1,650 @@
+/*****************************************************************
+Name    :skiplist_queue
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 epoch-based reclamation of the unlinked nodes
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "key_index.h"
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#define MAX_THREADS (64)
+#define MAX_LEVEL (32)
+#define BOUND_OFFSET (32)
+#define EPOCH_SLOTS (2*MAX_THREADS)
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The baselines, see binary_heap.cpp and fibonacci_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main fibonacci_heap_main
+namespace fibonacci{
+#include "fibonacci_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+//Lock-free skiplist priority queue (Linden and Jonsson, 2013)
+//The lowest bit of next[0] marks the successor as deleted, so the deleted
+//nodes are always a prefix of the bottom list. extract_min marks the first
+//unmarked pointer with one fetch_or, and only when the prefix grows longer
+//than BOUND_OFFSET one CAS on head moves it past the whole prefix, so the
+//physical deletion is batched.
+//The unlinked nodes are freed by epochs. Every operation publishes the
+//global epoch it saw in its thread's slot, a node unlinked in epoch e goes
+//to the limbo list of that thread for e, and is freed by the thread once
+//the global epoch is e+2. The epoch only moves on when every thread in an
+//operation has seen it, so no thread can still hold the node. A stalled
+//thread stops the epoch, otherwise a thread keeps at most the nodes of
+//the last three epochs it retired in, the lists of a thread that is gone
+//wait for the next thread with its slot, or for the destructor.
+struct SkipNode{
+    int data;
+    int height;
+    atomic<bool> inserting;
+    atomic<uintptr_t> *next;
+
+    //limbo list
+    SkipNode *retired=NULL;
+};
+
+//the state of one thread in one queue, only that thread uses the lists
+struct EpochSlot{
+    atomic<uint64_t> epoch;     //(epoch << 1) | 1 inside an operation, else 0
+    SkipNode *limbo[3];         //by epoch % 3
+    uint64_t limbo_epoch[3];
+};
+
+//Every thread takes one slot index while it lives, the same one in
+//every queue, so a slot has one thread at a time.
+static atomic<bool> slot_taken[EPOCH_SLOTS];
+
+struct ThreadSlot{
+    int index=-1;
+
+    ThreadSlot();
+    ~ThreadSlot();
+};
+
+ThreadSlot::ThreadSlot()
+{
+    while(index < 0){
+        for(int i=0; i<EPOCH_SLOTS; i++){
+            bool expected = false;
+            if(slot_taken[i].compare_exchange_strong(expected, true)){
+                index = i;
+                break;
+            }
+        }
+        if(index < 0){
+            this_thread::yield();
+        }
+    }
+}
+
+ThreadSlot::~ThreadSlot()
+{
+    slot_taken[index] = false;
+}
+
+static int thread_slot(void)
+{
+    static thread_local ThreadSlot slot;
+    return slot.index;
+}
+
+class SkipListQueue{
+    SkipNode *head;
+    SkipNode *tail;
+    atomic<uint64_t> global_epoch;
+    EpochSlot slot[EPOCH_SLOTS];
+
+    //core operation
+    SkipNode *newNode(int input, int height);
+    static size_t nodeBytes(SkipNode *input);
+    static void deleteNode(SkipNode *input);
+    int randomHeight(void);
+    SkipNode *locatePreds(int key, SkipNode **preds, SkipNode **succs);
+    void restructure(void);
+
+    //epochs
+    int enter(void);
+    void leave(int s);
+    void retire(int s, SkipNode *input);
+    void freeLimbo(int s, int b);
+    void tryAdvance(void);
+public:
+    //bytes of the unlinked nodes not freed yet, and the most at a time
+    atomic<long long> unreclaimed;
+    atomic<long long> unreclaimed_peak;
+
+    SkipListQueue();
+    ~SkipListQueue();
+    void insert(int input);
+    int extract_min();
+    int minimum();
+};
+
+//marked pointers
+static inline bool is_marked(uintptr_t p)
+{
+    return p & 1;
+}
+
+static inline SkipNode *unmarked(uintptr_t p)
+{
+    return (SkipNode *)(p & ~(uintptr_t)1);
+}
+
+SkipNode *SkipListQueue::newNode(int input, int height)
+{
+    SkipNode *node = new SkipNode();
+    node->data = input;
+    node->height = height;
+    node->inserting = false;
+    node->next = new atomic<uintptr_t>[height];
+    for(int i=0; i<height; i++){
+        node->next[i] = 0;
+    }
+
+    return node;
+}
+
+size_t SkipListQueue::nodeBytes(SkipNode *input)
+{
+    return sizeof(SkipNode) + input->height * sizeof(atomic<uintptr_t>);
+}
+
+void SkipListQueue::deleteNode(SkipNode *input)
+{
+    delete [] input->next;
+    delete input;
+}
+
+//geometric height, p = 1/2, xorshift per thread
+int SkipListQueue::randomHeight(void)
+{
+    static thread_local uint32_t seed =
+        hash<thread::id>()(this_thread::get_id()) | 1;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    int height = 1;
+    uint32_t bits = seed;
+    while((bits & 1) && height < MAX_LEVEL){
+        height++;
+        bits >>= 1;
+    }
+
+    return height;
+}
+
+//Initialize, head and tail are the sentinels of every level
+SkipListQueue::SkipListQueue()
+{
+    global_epoch = 0;
+    unreclaimed = 0;
+    unreclaimed_peak = 0;
+    for(int s=0; s<EPOCH_SLOTS; s++){
+        slot[s].epoch = 0;
+        for(int b=0; b<3; b++){
+            slot[s].limbo[b] = NULL;
+            slot[s].limbo_epoch[b] = 0;
+        }
+    }
+    tail = newNode(INT_MAX, MAX_LEVEL);
+    head = newNode(INT_MIN, MAX_LEVEL);
+    for(int i=0; i<MAX_LEVEL; i++){
+        head->next[i] = (uintptr_t)tail;
+    }
+}
+
+//free the limbo lists, then the list itself
+SkipListQueue::~SkipListQueue()
+{
+    for(int s=0; s<EPOCH_SLOTS; s++){
+        for(int b=0; b<3; b++){
+            freeLimbo(s, b);
+        }
+    }
+
+    SkipNode *current = head;
+    while(current){
+        SkipNode *next_node = (current == tail) ? NULL : unmarked(current->next[0]);
+        deleteNode(current);
+        current = next_node;
+    }
+}
+
+//publish the epoch, then free the own lists two epochs behind it.
+//Return the slot of the thread.
+int SkipListQueue::enter(void)
+{
+    int s = thread_slot();
+    uint64_t e = global_epoch.load();
+    slot[s].epoch.store((e << 1) | 1);
+
+    for(int b=0; b<3; b++){
+        if(slot[s].limbo[b] && slot[s].limbo_epoch[b] + 2 <= e){
+            freeLimbo(s, b);
+        }
+    }
+
+    return s;
+}
+
+void SkipListQueue::leave(int s)
+{
+    slot[s].epoch.store(0, memory_order_release);
+}
+
+//into the list of the current epoch, the list of the same epoch three
+//epochs ago is freed first
+void SkipListQueue::retire(int s, SkipNode *input)
+{
+    uint64_t e = global_epoch.load();
+    int b = e % 3;
+    if(slot[s].limbo[b] && slot[s].limbo_epoch[b] != e){
+        freeLimbo(s, b);
+    }
+    input->retired = slot[s].limbo[b];
+    slot[s].limbo[b] = input;
+    slot[s].limbo_epoch[b] = e;
+}
+
+void SkipListQueue::freeLimbo(int s, int b)
+{
+    long long bytes = 0;
+    SkipNode *current = slot[s].limbo[b];
+    while(current){
+        SkipNode *next_node = current->retired;
+        bytes += nodeBytes(current);
+        deleteNode(current);
+        current = next_node;
+    }
+    slot[s].limbo[b] = NULL;
+    unreclaimed -= bytes;
+}
+
+//next epoch, once every thread in an operation has seen this one
+void SkipListQueue::tryAdvance(void)
+{
+    uint64_t e = global_epoch.load();
+    for(int s=0; s<EPOCH_SLOTS; s++){
+        uint64_t local = slot[s].epoch.load();
+        if((local & 1) && (local >> 1) != e)
+            return;
+    }
+    global_epoch.compare_exchange_strong(e, e+1);
+}
+
+//the last node before the key on every level, skipping the deleted
+//nodes, returns the last deleted node seen on the bottom level
+SkipNode *SkipListQueue::locatePreds(int key, SkipNode **preds, SkipNode **succs)
+{
+    SkipNode *pred = head;
+    SkipNode *del = NULL;
+
+    for(int i=MAX_LEVEL-1; i>=0; i--){
+        uintptr_t p = pred->next[i];
+        bool d = is_marked(p);
+        SkipNode *current = unmarked(p);
+
+        while(current->data < key || is_marked(current->next[0]) ||
+              (0 == i && d)){
+            if(0 == i && d){
+                del = current;
+            }
+            pred = current;
+            p = pred->next[i];
+            d = is_marked(p);
+            current = unmarked(p);
+        }
+        preds[i] = pred;
+        succs[i] = current;
+    }
+
+    return del;
+}
+
+//swing the upper levels of head past the deleted prefix
+void SkipListQueue::restructure(void)
+{
+    SkipNode *pred = head;
+    int i = MAX_LEVEL - 1;
+    while(i > 0){
+        SkipNode *h = unmarked(head->next[i]);
+        if(!is_marked(h->next[0])){
+            i--;
+            continue;
+        }
+
+        SkipNode *current = unmarked(pred->next[i]);
+        while(is_marked(current->next[0])){
+            pred = current;
+            current = unmarked(pred->next[i]);
+        }
+
+        uintptr_t expected = (uintptr_t)h;
+        if(head->next[i].compare_exchange_strong(expected, pred->next[i].load())){
+            i--;
+        }
+    }
+}
+
+//insert, link the bottom level first, then the upper levels
+void SkipListQueue::insert(int input)
+{
+    SkipNode *preds[MAX_LEVEL];
+    SkipNode *succs[MAX_LEVEL];
+    int height = randomHeight();
+    SkipNode *node = newNode(input, height);
+    node->inserting = true;
+    int s = enter();
+
+    SkipNode *del;
+    while(true){
+        del = locatePreds(input, preds, succs);
+        node->next[0] = (uintptr_t)succs[0];
+
+        uintptr_t expected = (uintptr_t)succs[0];
+        if(preds[0]->next[0].compare_exchange_strong(expected, (uintptr_t)node))
+            break;
+    }
+
+    int i = 1;
+    while(i < height){
+        node->next[i] = (uintptr_t)succs[i];
+
+        //give up on the upper levels once the node or its successor is gone
+        if(is_marked(node->next[0]) || is_marked(succs[i]->next[0]) ||
+           del == succs[i])
+            break;
+
+        uintptr_t expected = (uintptr_t)succs[i];
+        if(preds[i]->next[i].compare_exchange_strong(expected, (uintptr_t)node)){
+            i++;
+        }else{
+            del = locatePreds(input, preds, succs);
+            if(succs[0] != node)
+                break;
+        }
+    }
+    node->inserting = false;
+    leave(s);
+}
+
+//extract min, -1 if empty
+int SkipListQueue::extract_min()
+{
+    int s = enter();
+    SkipNode *current = head;
+    SkipNode *new_head = NULL;
+    uintptr_t observed = head->next[0];
+    int offset = 0;
+
+    //walk the deleted prefix and mark the first live node
+    uintptr_t p;
+    do{
+        p = current->next[0];
+        if(unmarked(p) == tail){
+            leave(s);
+            return -1;
+        }
+
+        //a node still being inserted can not be unlinked yet
+        if(NULL == new_head && current->inserting){
+            new_head = current;
+        }
+        if(!is_marked(p)){
+            p = current->next[0].fetch_or(1);
+        }
+        offset++;
+        current = unmarked(p);
+    }while(is_marked(p));
+
+    int result = current->data;
+    if(NULL == new_head){
+        new_head = current;
+    }
+
+    //physical deletion only once the prefix is long enough
+    uintptr_t expected = observed;
+    if(offset > BOUND_OFFSET && head->next[0] == observed &&
+       head->next[0].compare_exchange_strong(expected, (uintptr_t)new_head | 1))
+    {
+        restructure();
+
+        long long bytes = 0;
+        SkipNode *node = unmarked(observed);
+        while(node != new_head){
+            SkipNode *next_node = unmarked(node->next[0]);
+            bytes += nodeBytes(node);
+            retire(s, node);
+            node = next_node;
+        }
+
+        long long now = (unreclaimed += bytes);
+        long long peak = unreclaimed_peak.load();
+        while(now > peak && !unreclaimed_peak.compare_exchange_weak(peak, now));
+        tryAdvance();
+    }
+    leave(s);
+
+    return result;
+}
+
+//minimum, the first node after the deleted prefix, -1 if empty
+int SkipListQueue::minimum()
+{
+    int s = enter();
+    SkipNode *current = head;
+    uintptr_t p = current->next[0];
+    while(is_marked(p)){
+        current = unmarked(p);
+        p = current->next[0];
+    }
+
+    int result = (unmarked(p) == tail) ? -1 : unmarked(p)->data;
+    leave(s);
+
+    return result;
+}
+
+//The strict baselines, one heap behind one lock
+template<class Heap>
+class LockedHeap{
+    mutex lock;
+    Heap heap;
+public:
+    LockedHeap();
+    void insert(int input);
+    int extract_min();
+};
+
+template<class Heap>
+LockedHeap<Heap>::LockedHeap() : heap(NULL, 0)
+{
+
+}
+
+template<class Heap>
+void LockedHeap<Heap>::insert(int input)
+{
+    lock_guard<mutex> guard(lock);
+    heap.insert(input);
+}
+
+template<class Heap>
+int LockedHeap<Heap>::extract_min()
+{
+    lock_guard<mutex> guard(lock);
+    return heap.extract_min();
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//the memory of the unlinked nodes, only the skiplist has any
+template<class Queue>
+void unreclaimed_note(Queue &)
+{
+
+}
+
+void unreclaimed_note(SkipListQueue &queue)
+{
+    cout << "    unreclaimed nodes :" << queue.unreclaimed / 1024
+         << " KB, peak :" << queue.unreclaimed_peak / 1024 << " KB" << endl;
+}
+
+//prefill, then every thread does its share of ops, half inserts and
+//half extract_min in random order
+template<class Queue>
+void throughput(const char *name, int threads, int *arr, int n, int ops)
+{
+    Queue queue;
+    for(int i=0; i<n; i++){
+        queue.insert(arr[i]);
+    }
+
+    atomic<long long> checksum(0);
+    vector<thread> workers;
+    auto start = high_resolution_clock::now();
+    for(int t=0; t<threads; t++){
+        workers.push_back(thread([&queue, &checksum, t, threads, arr, n, ops](){
+            uint32_t seed = 2026 + t;
+            long long local = 0;
+            for(int i=t; i<ops; i+=threads){
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                if(seed & 1){
+                    queue.insert(arr[i % n]);
+                }else{
+                    local += queue.extract_min();
+                }
+            }
+            checksum += local;
+        }));
+    }
+    for(int t=0; t<threads; t++){
+        workers[t].join();
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << name << " with " << threads << " threads: "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+    unreclaimed_note(queue);
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Insert the elements
+    cout << "\n\tInsert the elements" << endl;
+    SkipListQueue myQueue;
+    for(int i=0; i<n; i++){
+        myQueue.insert(random_data[i]);
+    }
+    cout << "minimum :" << myQueue.minimum() << endl;
+
+    // Test extract min
+    cout << "\n\tTest extract min" << endl;
+    cout << "extract_min :" << myQueue.extract_min() << endl;
+    cout << "minimum :" << myQueue.minimum() << endl;
+
+    // Heap sort
+    cout << "\n\tHeap sort" << endl;
+    cout << "Heap sort :";
+    int value;
+    while(-1 != (value = myQueue.extract_min())){
+        cout << value << " ";
+    }
+    cout << endl;
+    cout << "unreclaimed bytes :" << myQueue.unreclaimed << endl;
+
+    // Thread scaling
+    n = BENCH_SCALE;
+    int *bench_data = random_case(1, n);
+    int ops = 4 * n;
+    cout << "\n\tThread scaling, half insert and half extract_min" << endl;
+    for(int threads=1; threads<=MAX_THREADS; threads*=4){
+        throughput<SkipListQueue>("SkipListQueue", threads, bench_data, n, ops);
+        throughput<LockedHeap<binary::BinaryHeap> >("locked BinaryHeap",
+            threads, bench_data, n, ops);
+        throughput<LockedHeap<fibonacci::FibonacciHeap> >("locked FibonacciHeap",
+            threads, bench_data, n, ops);
+    }
+
+    return 0;
+}
+/*==============================================================*/
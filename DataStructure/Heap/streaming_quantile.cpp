@@ -0,0 +1,303 @@
+/*****************************************************************
+Name    :streaming_quantile
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The two heaps, see binary_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+//The baseline re-sorts every window.
+#define main quick_sort_main
+namespace quick{
+#include "../../Algorithm/Sort/Efficient/quick_sort.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+#define LOW (0)
+#define HIGH (1)
+
+//Streaming quantile with two heaps
+//The quantile of n samples is the one of rank r = ceil(q*n) in sorted
+//order, q is in thousandths, 500 is the median. The low heap is a max
+//heap of the r smallest samples, keyed by ~x so the order is reversed
+//without overflow, and the high heap a min heap of the rest, so the
+//quantile is the max of the low heap. A sample moves between the heaps
+//only to keep the low heap at r, which is one move per update.
+//With a window only the last window samples count. Each one has a slot
+//in a ring that knows its heap and handle, so the oldest sample is
+//dropped by delete_key on its handle.
+class StreamingQuantile{
+    binary::IndexedBinaryHeap heap[2];
+    vector<int> slot_of[2];     //handle -> slot, of each heap
+    vector<int> side;           //heap of each slot
+    vector<int> handle;         //handle of each slot
+    int permille;
+    int window;
+    long long count=0;          //samples so far
+
+    //core operation
+    void place(int slot, int s, int input);
+    void move(int from);
+    void rebalance(void);
+public:
+    StreamingQuantile(int permille, int window=0);
+    void insert(int input);
+    int quantile();
+    int size();
+};
+
+StreamingQuantile::StreamingQuantile(int permille, int window)
+    : permille(permille), window(window)
+{
+    if(window){
+        side.assign(window, -1);
+        handle.assign(window, -1);
+    }
+}
+
+//insert the sample into heap s and keep its slot
+void StreamingQuantile::place(int slot, int s, int input)
+{
+    int h = heap[s].insert(LOW == s ? ~input : input);
+    if(window){
+        if(h >= (int)slot_of[s].size()){
+            slot_of[s].resize(h+1);
+        }
+        slot_of[s][h] = slot;
+        side[slot] = s;
+        handle[slot] = h;
+    }
+}
+
+//move the top of one heap to the other one
+void StreamingQuantile::move(int from)
+{
+    int slot = window ? slot_of[from][heap[from].min_handle()] : -1;
+    int key = heap[from].extract_min();
+    place(slot, 1-from, LOW == from ? ~key : key);
+}
+
+//keep r samples in the low heap
+void StreamingQuantile::rebalance(void)
+{
+    int n = size();
+    int r = n ? max(1, (int)(((long long)permille * n + 999) / 1000)) : 0;
+    while(heap[LOW].size() > r){
+        move(LOW);
+    }
+    while(heap[LOW].size() < r){
+        move(HIGH);
+    }
+}
+
+//insert, the oldest sample of a full window is dropped first
+void StreamingQuantile::insert(int input)
+{
+    int slot = -1;
+    if(window){
+        slot = count % window;
+        if(count >= window){
+            heap[side[slot]].delete_key(handle[slot]);
+        }
+    }
+    count++;
+
+    if(heap[LOW].size() && input <= ~heap[LOW].minimum()){
+        place(slot, LOW, input);
+    }else{
+        place(slot, HIGH, input);
+    }
+    rebalance();
+}
+
+//the quantile, -1 if there is no sample
+int StreamingQuantile::quantile()
+{
+    if(0 == heap[LOW].size())
+        return -1;
+
+    return ~heap[LOW].minimum();
+}
+
+int StreamingQuantile::size()
+{
+    return heap[LOW].size() + heap[HIGH].size();
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//the quantile of rank ceil(q*n) in a sorted array
+int sorted_quantile(int *sorted, int n, int permille)
+{
+    int r = max(1, (int)(((long long)permille * n + 999) / 1000));
+    return sorted[r-1];
+}
+
+//p50, p90 and p99 of every window, with a pair of heaps for each
+long long bench_heaps(int *arr, int n, int window)
+{
+    StreamingQuantile p50(500, window), p90(900, window), p99(990, window);
+    long long checksum = 0;
+    for(int i=0; i<n; i++){
+        p50.insert(arr[i]);
+        p90.insert(arr[i]);
+        p99.insert(arr[i]);
+        checksum += p50.quantile() + p90.quantile() + p99.quantile();
+    }
+    return checksum;
+}
+
+//p50, p90 and p99 of every window, sorting a copy of it each time
+long long bench_sort(int *arr, int n, int window)
+{
+    vector<int> copy(window);
+    long long checksum = 0;
+    for(int i=0; i<n; i++){
+        int start = max(0, i+1-window);
+        int len = i+1 - start;
+        memcpy(copy.data(), arr+start, len*sizeof(int));
+        quick::quick_sort(copy.data(), 0, len-1);
+        checksum += sorted_quantile(copy.data(), len, 500) +
+            sorted_quantile(copy.data(), len, 900) +
+            sorted_quantile(copy.data(), len, 990);
+    }
+    return checksum;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Running median
+    cout << "\n\tRunning median :";
+    StreamingQuantile median(500);
+    for(int i=0; i<n; i++){
+        median.insert(random_data[i]);
+        cout << median.quantile() << " ";
+    }
+    cout << endl;
+
+    // Sliding window
+    int window = 5;
+    cout << "\n\tWindow of " << window << ", median and p90" << endl;
+    StreamingQuantile window_median(500, window), window_p90(900, window);
+    for(int i=0; i<n; i++){
+        window_median.insert(random_data[i]);
+        window_p90.insert(random_data[i]);
+        cout << window_median.quantile() << "/" << window_p90.quantile() << " ";
+    }
+    cout << endl;
+
+    // Benchmark running median
+    int bench_n = BENCH_SCALE;
+    int *bench_data = random_case(1, bench_n);
+    cout << "\n\tBenchmark running median of " << bench_n << " samples" << endl;
+    auto start = high_resolution_clock::now();
+    StreamingQuantile running(500);
+    long long checksum = 0;
+    for(int i=0; i<bench_n; i++){
+        running.insert(bench_data[i]);
+        checksum += running.quantile();
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by running median: "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+
+    // Benchmark sliding windows, re-sorting is slow so the stream is
+    // shorter
+    int stream = bench_n / 20;
+    int windows[] = {128, 1024};
+    for(int w : windows){
+        cout << "\n\tBenchmark p50, p90 and p99 of a window of " << w
+             << ", " << stream << " samples" << endl;
+        start = high_resolution_clock::now();
+        checksum = bench_heaps(bench_data, stream, w);
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by heaps: "
+             << duration.count() << " microseconds"
+             << ", checksum :" << checksum << endl;
+
+        start = high_resolution_clock::now();
+        checksum = bench_sort(bench_data, stream, w);
+        stop = high_resolution_clock::now();
+        duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by quick_sort of every window: "
+             << duration.count() << " microseconds"
+             << ", checksum :" << checksum << endl;
+    }
+
+    return 0;
+}
+/*==============================================================*/
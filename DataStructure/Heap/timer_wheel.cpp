@@ -0,0 +1,535 @@
+/*****************************************************************
+Name    :timer_wheel
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 advance jumps to the next occupied slot
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (10000000)
+#endif
+#define WHEEL_BITS (6)
+#define WHEEL_SLOTS (1<<WHEEL_BITS)
+#define WHEEL_LEVELS (4)
+#define WHEEL_SPAN_BITS (WHEEL_BITS*WHEEL_LEVELS)
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The overflow heap, see binary_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+//slot of a timer in the overflow heap or on the free list
+#define SLOT_OVERFLOW (-1)
+#define SLOT_FREE (-2)
+
+//The timers are kept in an arena, the handle is the index.
+//prev and next link the timers of one slot, next is also the free list.
+struct Timer{
+    long long expire;
+    int prev;
+    int next;
+    int slot;           //level*WHEEL_SLOTS+index, or SLOT_OVERFLOW / SLOT_FREE
+    int heap_handle;    //handle in the overflow heap
+    int data;
+};
+
+//Hierarchical timing wheel with a heap for the far future
+//Level l has WHEEL_SLOTS slots of 2^(WHEEL_BITS*l) ticks each, and only
+//covers the block of the level above that holds now. A timer goes to the
+//lowest level whose block holds both now and the expiry, and moves down
+//a level when now reaches its slot. The timers past the top block go to
+//an IndexedBinaryHeap keyed by expire >> WHEEL_SPAN_BITS, which is
+//emptied into the wheel whenever now enters a new top block.
+//schedule, cancel and reschedule are O(1) in the wheel and O(log n) for
+//the few timers in the heap.
+class TimerWheel{
+    vector<Timer> pool;
+    int free_list=-1;
+    int head[WHEEL_LEVELS*WHEEL_SLOTS];
+
+    //bit i of level l is set if slot i is not empty
+    uint64_t nonempty[WHEEL_LEVELS];
+
+    //far future, key -> timer through the heap handle
+    binary::IndexedBinaryHeap overflow;
+    vector<int> timer_of;
+
+    //core operation
+    int allocate(long long expire, int data);
+    void release(int handle);
+    void link(int handle, int slot);
+    void unlink(int handle);
+    void place(int handle);
+    void cascade(int level);
+    void pullOverflow(void);
+    long long nextTick(void);
+public:
+    long long now=0;
+    int number=0;
+
+    //the data of the timers fired by the last advance
+    vector<int> expired;
+
+    TimerWheel();
+    int schedule(long long expire, int data);
+    void cancel(int handle);
+    int reschedule(int handle, long long expire);
+    int advance(long long to);
+};
+
+TimerWheel::TimerWheel()
+{
+    for(int i=0; i<WHEEL_LEVELS*WHEEL_SLOTS; i++){
+        head[i] = -1;
+    }
+    for(int l=0; l<WHEEL_LEVELS; l++){
+        nonempty[l] = 0;
+    }
+}
+
+//take a timer from the free list or grow the arena
+int TimerWheel::allocate(long long expire, int data)
+{
+    int handle;
+    if(free_list != -1){
+        handle = free_list;
+        free_list = pool[handle].next;
+    }else{
+        handle = pool.size();
+        pool.push_back(Timer());
+    }
+
+    Timer &timer = pool[handle];
+    timer.expire = expire;
+    timer.prev = timer.next = -1;
+    timer.data = data;
+
+    return handle;
+}
+
+void TimerWheel::release(int handle)
+{
+    pool[handle].slot = SLOT_FREE;
+    pool[handle].next = free_list;
+    free_list = handle;
+}
+
+//core operation
+void TimerWheel::link(int handle, int slot)
+{
+    Timer &timer = pool[handle];
+    timer.slot = slot;
+    timer.prev = -1;
+    timer.next = head[slot];
+    if(head[slot] != -1){
+        pool[head[slot]].prev = handle;
+    }
+    head[slot] = handle;
+    nonempty[slot / WHEEL_SLOTS] |= (uint64_t)1 << (slot % WHEEL_SLOTS);
+}
+
+//core operation, from its slot or from the heap
+void TimerWheel::unlink(int handle)
+{
+    Timer &timer = pool[handle];
+    if(SLOT_OVERFLOW == timer.slot){
+        overflow.delete_key(timer.heap_handle);
+        return;
+    }
+
+    int slot = timer.slot;
+    if(timer.prev != -1){
+        pool[timer.prev].next = timer.next;
+    }else{
+        head[slot] = timer.next;
+    }
+    if(timer.next != -1){
+        pool[timer.next].prev = timer.prev;
+    }
+    if(-1 == head[slot]){
+        nonempty[slot / WHEEL_SLOTS] &= ~((uint64_t)1 << (slot % WHEEL_SLOTS));
+    }
+}
+
+//core operation, the lowest level whose block holds now and the expiry
+void TimerWheel::place(int handle)
+{
+    long long expire = pool[handle].expire;
+    if((expire >> WHEEL_SPAN_BITS) != (now >> WHEEL_SPAN_BITS)){
+        int heap_handle = overflow.insert((int)(expire >> WHEEL_SPAN_BITS));
+        if(heap_handle >= (int)timer_of.size()){
+            timer_of.resize(heap_handle+1);
+        }
+        timer_of[heap_handle] = handle;
+        pool[handle].heap_handle = heap_handle;
+        pool[handle].slot = SLOT_OVERFLOW;
+        return;
+    }
+
+    int level = 0;
+    while((expire >> (WHEEL_BITS*(level+1))) != (now >> (WHEEL_BITS*(level+1)))){
+        level++;
+    }
+    int index = (expire >> (WHEEL_BITS*level)) & (WHEEL_SLOTS-1);
+    link(handle, level*WHEEL_SLOTS + index);
+}
+
+//core operation, now has reached the slot of the level, move its
+//timers down
+void TimerWheel::cascade(int level)
+{
+    int slot = level*WHEEL_SLOTS + ((now >> (WHEEL_BITS*level)) & (WHEEL_SLOTS-1));
+    int current = head[slot];
+    head[slot] = -1;
+    nonempty[level] &= ~((uint64_t)1 << (slot % WHEEL_SLOTS));
+
+    while(current != -1){
+        int next_timer = pool[current].next;
+        place(current);
+        current = next_timer;
+    }
+}
+
+//core operation, now has entered a new top block
+void TimerWheel::pullOverflow(void)
+{
+    int block = (int)(now >> WHEEL_SPAN_BITS);
+    while(overflow.size() && overflow.minimum() == block){
+        int handle = timer_of[overflow.min_handle()];
+        overflow.extract_min();
+        place(handle);
+    }
+}
+
+//the next tick with work to do: the next timer on level 0, else the
+//start of the next occupied slot of the lowest level that has one, else
+//the top block of the first timer in the heap, LLONG_MAX if none.
+//A slot of level l after now starts before any later slot of level l+1,
+//so the lowest level with an occupied slot after now is the earliest.
+long long TimerWheel::nextTick(void)
+{
+    for(int l=0; l<WHEEL_LEVELS; l++){
+        int shift = ((now >> (WHEEL_BITS*l)) & (WHEEL_SLOTS-1)) + 1;
+        uint64_t mask = (shift < WHEEL_SLOTS) ? nonempty[l] & (~(uint64_t)0 << shift) : 0;
+        if(mask){
+            long long block = (now >> (WHEEL_BITS*(l+1))) << (WHEEL_BITS*(l+1));
+            return block + ((long long)__builtin_ctzll(mask) << (WHEEL_BITS*l));
+        }
+    }
+
+    if(overflow.size()){
+        return (long long)overflow.minimum() << WHEEL_SPAN_BITS;
+    }
+
+    return LLONG_MAX;
+}
+
+//schedule, a timer at or before now fires on the next tick
+int TimerWheel::schedule(long long expire, int data)
+{
+    if(expire <= now){
+        expire = now + 1;
+    }
+
+    int handle = allocate(expire, data);
+    place(handle);
+    number++;
+
+    return handle;
+}
+
+//cancel
+void TimerWheel::cancel(int handle)
+{
+    if(handle < 0 || handle >= (int)pool.size() || SLOT_FREE == pool[handle].slot)
+        return;
+
+    unlink(handle);
+    release(handle);
+    number--;
+}
+
+//reschedule, earlier or later, the handle stays the same
+int TimerWheel::reschedule(int handle, long long expire)
+{
+    if(handle < 0 || handle >= (int)pool.size() || SLOT_FREE == pool[handle].slot)
+        return -1;
+
+    if(expire <= now){
+        expire = now + 1;
+    }
+
+    unlink(handle);
+    pool[handle].expire = expire;
+    place(handle);
+
+    return handle;
+}
+
+//advance the time, fire the timers up to and including the tick to
+//returns the number of fired timers, their data is in expired
+int TimerWheel::advance(long long to)
+{
+    expired.clear();
+
+    while(true){
+        long long tick = nextTick();
+        if(tick > to)
+            break;
+        now = tick;
+
+        //from the top level down, then fire the level-0 slot
+        if(0 == (now & (((long long)1 << WHEEL_SPAN_BITS) - 1))){
+            pullOverflow();
+        }
+        for(int l=WHEEL_LEVELS-1; l>0; l--){
+            if(0 == (now & (((long long)1 << (WHEEL_BITS*l)) - 1))){
+                cascade(l);
+            }
+        }
+
+        int slot = now & (WHEEL_SLOTS-1);
+        int current = head[slot];
+        head[slot] = -1;
+        nonempty[0] &= ~((uint64_t)1 << slot);
+        while(current != -1){
+            int next_timer = pool[current].next;
+            expired.push_back(pool[current].data);
+            release(current);
+            number--;
+            current = next_timer;
+        }
+    }
+
+    //no timer between the last tick and to
+    if(to > now){
+        now = to;
+    }
+
+    return expired.size();
+}
+
+//The baseline, every timer in one IndexedBinaryHeap keyed by the expiry
+//reschedule is delete and insert, the heap can only decrease a key
+class HeapTimers{
+    binary::IndexedBinaryHeap heap;
+    vector<int> data_of;
+public:
+    long long now=0;
+    vector<int> expired;
+
+    int schedule(long long expire, int data);
+    void cancel(int handle);
+    int reschedule(int handle, long long expire);
+    int advance(long long to);
+};
+
+int HeapTimers::schedule(long long expire, int data)
+{
+    if(expire <= now){
+        expire = now + 1;
+    }
+
+    int handle = heap.insert((int)expire);
+    if(handle >= (int)data_of.size()){
+        data_of.resize(handle+1);
+    }
+    data_of[handle] = data;
+
+    return handle;
+}
+
+void HeapTimers::cancel(int handle)
+{
+    heap.delete_key(handle);
+}
+
+int HeapTimers::reschedule(int handle, long long expire)
+{
+    int data = data_of[handle];
+    heap.delete_key(handle);
+    return schedule(expire, data);
+}
+
+int HeapTimers::advance(long long to)
+{
+    expired.clear();
+    while(heap.size() && heap.minimum() <= to){
+        expired.push_back(data_of[heap.min_handle()]);
+        heap.extract_min();
+    }
+    now = to;
+
+    return expired.size();
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//timeout of a connection, 1 in 100 is far in the future
+long long random_timeout(uint32_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    if(0 == seed % 100){
+        return (1 << WHEEL_SPAN_BITS) + seed % (1 << 26);
+    }
+    return 1 + seed % 60000;
+}
+
+//Timeout-heavy trace, live timers that are mostly pushed back or
+//cancelled and scheduled again before they fire. Every tick does
+//ops_per_tick operations, a fired timer is scheduled again.
+template<class Service>
+void timeout_trace(const char *name, int live, int ticks, int ops_per_tick)
+{
+    Service service;
+    vector<int> handle_of(live);
+    uint32_t seed = 2026;
+    long long checksum = 0;
+
+    auto start = high_resolution_clock::now();
+    for(int id=0; id<live; id++){
+        handle_of[id] = service.schedule(random_timeout(seed), id);
+    }
+
+    for(int t=1; t<=ticks; t++){
+        for(int k=0; k<ops_per_tick; k++){
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            int id = seed % live;
+
+            if(seed & (1 << 30)){
+                handle_of[id] = service.reschedule(handle_of[id],
+                    service.now + random_timeout(seed));
+            }else{
+                service.cancel(handle_of[id]);
+                handle_of[id] = service.schedule(
+                    service.now + random_timeout(seed), id);
+            }
+        }
+
+        //the order of the fired timers is up to the service
+        service.advance(t);
+        sort(service.expired.begin(), service.expired.end());
+        for(int i=0; i<(int)service.expired.size(); i++){
+            int id = service.expired[i];
+            checksum += id;
+            handle_of[id] = service.schedule(
+                service.now + random_timeout(seed), id);
+        }
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by " << name << ": "
+         << duration.count() << " microseconds"
+         << ", checksum :" << checksum << endl;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Schedule the timers
+    cout << "\n\tSchedule timers, timer i expires at tick 100*data" << endl;
+    TimerWheel myWheel;
+    vector<int> handle(n+1);
+    for(int i=0; i<n; i++){
+        handle[random_data[i]] = myWheel.schedule(100LL * random_data[i], random_data[i]);
+    }
+    int far_handle = myWheel.schedule(1LL << 30, 99);
+    cout << "number :" << myWheel.number << endl;
+
+    // Cancel and reschedule
+    cout << "\n\tCancel 3, reschedule 5 to tick 2500 and 18 to tick 50" << endl;
+    myWheel.cancel(handle[3]);
+    myWheel.reschedule(handle[5], 2500);
+    myWheel.reschedule(handle[18], 50);
+
+    // Advance
+    cout << "\n\tAdvance" << endl;
+    long long steps[] = {1000, 2500, 100000, 1LL << 30};
+    for(int i=0; i<4; i++){
+        myWheel.advance(steps[i]);
+        cout << "now :" << myWheel.now << ", fired :";
+        for(int j=0; j<(int)myWheel.expired.size(); j++){
+            cout << myWheel.expired[j] << " ";
+        }
+        cout << endl;
+    }
+    cout << "far timer " << far_handle << " fired, number :"
+         << myWheel.number << endl;
+
+    // Benchmark timeout-heavy trace
+    int live = BENCH_SCALE;
+    int ticks = 1000;
+    int ops_per_tick = live / 1000;
+    cout << "\n\tBenchmark timeout-heavy trace, " << live << " live timers, "
+         << ticks << " ticks, " << ops_per_tick << " ops per tick" << endl;
+    timeout_trace<TimerWheel>("TimerWheel", live, ticks, ops_per_tick);
+    timeout_trace<HeapTimers>("IndexedBinaryHeap timers", live, ticks, ops_per_tick);
+
+    return 0;
+}
+/*==============================================================*/
@@ -0,0 +1,317 @@
+/*****************************************************************
+Name    :top_k
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include "heap_stats.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#ifndef TOPK_BATCH
+#define TOPK_BATCH (4096)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The bounded heap, see binary_heap.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+#define DEBUG (1)
+#define SCALE (20)
+
+//Streaming top-k
+//The k largest keys so far are in a BinaryHeap, its min is the
+//threshold a new key has to beat, so a key equal to it loses and the
+//earlier one stays. Once the heap is full almost every key loses.
+//push_batch compares whole vectors of keys with the threshold and only
+//the winners touch the heap, with replace_min, so the cost per key is
+//close to a scan of the batch. The threshold only grows.
+class TopK{
+    binary::BinaryHeap heap;
+    int k;
+
+    //core operation
+    int admit(int input);
+public:
+    long long survivors=0;      //keys that went into the heap
+
+    TopK(int k);
+    void push(int input);
+    void push_batch(int *arr, int n);
+    bool full();
+    int threshold();
+    int size();
+
+    //the top k, largest first
+    vector<int> result(void);
+};
+
+TopK::TopK(int k) : heap(NULL, 0), k(k)
+{
+
+}
+
+//the key beats the threshold, it replaces the min, return the new one
+int TopK::admit(int input)
+{
+    heap.replace_min(input);
+    survivors++;
+    return heap.minimum();
+}
+
+//one key, the way without batches
+void TopK::push(int input)
+{
+    if((int)heap.data.size() < k){
+        heap.insert(input);
+        survivors++;
+    }else if(k && input > heap.minimum()){
+        admit(input);
+    }
+}
+
+//fill the heap, then compare 32 keys at a time with AVX2, or 4 with
+//SSE4.1, a block without a winner costs one test
+void TopK::push_batch(int *arr, int n)
+{
+    int i = 0;
+    while(i < n && (int)heap.data.size() < k){
+        heap.insert(arr[i++]);
+        survivors++;
+    }
+    if(i == n || 0 == k)
+        return;
+
+    int t = heap.minimum();
+#if defined(__AVX2__)
+    __m256i thr = _mm256_set1_epi32(t);
+    for(; i+32<=n; i+=32){
+        __m256i c0 = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(arr+i)), thr);
+        __m256i c1 = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(arr+i+8)), thr);
+        __m256i c2 = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(arr+i+16)), thr);
+        __m256i c3 = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(arr+i+24)), thr);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+        if(_mm256_testz_si256(any, any))
+            continue;
+
+        //the winners in order, the threshold may rise on the way
+        uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c0))
+            | (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c1)) << 8
+            | (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c2)) << 16
+            | (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(c3)) << 24;
+        while(mask){
+            int input = arr[i + __builtin_ctz(mask)];
+            mask &= mask - 1;
+            if(input > t){
+                t = admit(input);
+            }
+        }
+        thr = _mm256_set1_epi32(t);
+    }
+#endif
+#if defined(__SSE4_1__)
+    __m128i thr4 = _mm_set1_epi32(t);
+    for(; i+4<=n; i+=4){
+        __m128i c = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(arr+i)), thr4);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(c));
+        if(0 == mask)
+            continue;
+
+        while(mask){
+            int input = arr[i + __builtin_ctz(mask)];
+            mask &= mask - 1;
+            if(input > t){
+                t = admit(input);
+            }
+        }
+        thr4 = _mm_set1_epi32(t);
+    }
+#endif
+    for(; i<n; i++){
+        if(arr[i] > t){
+            t = admit(arr[i]);
+        }
+    }
+}
+
+//the heap has k keys, so there is a threshold
+bool TopK::full()
+{
+    return (int)heap.data.size() >= k;
+}
+
+//the key to beat, INT_MIN if the heap is not full yet
+int TopK::threshold()
+{
+    if(!full() || 0 == k)
+        return INT_MIN;
+
+    return heap.minimum();
+}
+
+int TopK::size()
+{
+    return heap.data.size();
+}
+
+vector<int> TopK::result(void)
+{
+    vector<int> top(heap.data);
+    sort(top.begin(), top.end(), greater<int>());
+    return top;
+}
+
+/*==============================================================*/
+//Function area
+int *random_case(int base, int number)
+{
+    int *result = new int[number];
+
+    //generate index ordered arrary
+    for(int i=0; i<number; i++){
+        result[i] = base + i;
+    }
+
+    //swap each position
+    srand(time(NULL));
+    for(int i=0; i<number-1; i++){
+        int j = i + rand() % (number-i);
+        //swap
+        int t=result[i];
+        result[i] = result[j];
+        result[j]=t;
+    }
+
+    return result;
+}
+
+//the sum of the top k, to compare the ways
+long long top_sum(vector<int> &top)
+{
+    long long sum = 0;
+    for(int i=0; i<(int)top.size(); i++){
+        sum += top[i];
+    }
+    return sum;
+}
+
+//insert every key and extract the min when the heap has k+1
+void bench_insert_extract(const char *name, int *arr, int n, int k)
+{
+    auto start = high_resolution_clock::now();
+    binary::BinaryHeap heap(NULL, 0);
+    for(int i=0; i<n; i++){
+        heap.insert(arr[i]);
+        if((int)heap.data.size() > k){
+            heap.extract_min();
+        }
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    cout << "Time taken by insert and extract_min on " << name << ": "
+         << duration.count() << " microseconds"
+         << ", checksum :" << top_sum(heap.data) << endl;
+}
+
+//one key at a time against the threshold, or in batches
+void bench_topk(const char *name, int *arr, int n, int k, bool batch)
+{
+    auto start = high_resolution_clock::now();
+    TopK top(k);
+    if(batch){
+        for(int i=0; i<n; i+=TOPK_BATCH){
+            top.push_batch(arr+i, min(TOPK_BATCH, n-i));
+        }
+    }else{
+        for(int i=0; i<n; i++){
+            top.push(arr[i]);
+        }
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    vector<int> result = top.result();
+    cout << "Time taken by " << (batch ? "push_batch" : "push") << " on " << name << ": "
+         << duration.count() << " microseconds"
+         << ", survivors :" << top.survivors
+         << ", checksum :" << top_sum(result) << endl;
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    int n=SCALE;
+
+    //generate data
+    int *random_data = random_case(1, n);
+
+#if DEBUG
+    cout << "Generate Data :";
+    for(int i=0; i<n; i++){
+        cout << random_data[i] << " ";
+    }
+    cout << endl;
+#endif
+
+    // Top 5 of the stream
+    cout << "\n\tTop 5 in batches of 7" << endl;
+    TopK myTop(5);
+    for(int i=0; i<n; i+=7){
+        myTop.push_batch(random_data+i, min(7, n-i));
+        if(myTop.full()){
+            cout << "threshold :" << myTop.threshold() << endl;
+        }else{
+            cout << "not full, size :" << myTop.size() << endl;
+        }
+    }
+    vector<int> top = myTop.result();
+    cout << "top 5 :";
+    for(int i=0; i<(int)top.size(); i++){
+        cout << top[i] << " ";
+    }
+    cout << endl;
+
+    // Benchmark, random keys and a rising stream where every key wins
+    int bench_n = 16*BENCH_SCALE;
+    int *stream = new int[bench_n];
+    int *rising = new int[bench_n];
+    srand(2026);
+    for(int i=0; i<bench_n; i++){
+        stream[i] = (((unsigned)rand() << 8) ^ (unsigned)rand()) & INT_MAX;
+        rising[i] = i;
+    }
+    int ks[] = {100, 10000};
+    for(int k : ks){
+        cout << "\n\tBenchmark top " << k << " of " << bench_n << " keys" << endl;
+        bench_insert_extract("random keys", stream, bench_n, k);
+        bench_topk("random keys", stream, bench_n, k, false);
+        bench_topk("random keys", stream, bench_n, k, true);
+        bench_topk("rising keys", rising, bench_n, k, false);
+        bench_topk("rising keys", rising, bench_n, k, true);
+    }
+
+    return 0;
+}
+/*==============================================================*/
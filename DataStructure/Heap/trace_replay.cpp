@@ -0,0 +1,512 @@
+/*****************************************************************
+Name    :trace_replay
+Author  :srhuang
+Email   :lukyandy3162@gmail.com
+History :
+    20261019 free the recorders after every heap is drained
+    20261019 merge the indexed heaps in linear time
+    20261019 Initial Version
+*****************************************************************/
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+#include <malloc.h>
+#include <unistd.h>
+#include "key_index.h"
+#include "heap_stats.h"
+#include "heap_trace.h"
+#ifndef BENCH_SCALE
+#define BENCH_SCALE (1000000)
+#endif
+#ifndef MEMORY_SAMPLE
+#define MEMORY_SAMPLE (4096)
+#endif
+using namespace std;
+using namespace std::chrono;
+
+/*==============================================================*/
+//Global area
+//The heaps, each one in its own namespace, see heap_benchmark.cpp.
+#define main binary_heap_main
+namespace binary{
+#include "binary_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main binomial_heap_main
+namespace binomial{
+#include "binomial_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main leftist_heap_main
+namespace leftist{
+#include "leftist_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main fibonacci_heap_main
+namespace fibonacci{
+#include "fibonacci_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+#define main pairing_heap_main
+namespace pairing{
+#include "pairing_heap.cpp"
+}
+#undef main
+#undef DEBUG
+#undef SCALE
+
+//The heaps of a trace and the handle of every id. The replay never
+//extracts from an empty heap, so the adapters don't check for it.
+//Node heaps keep a node with its key, so the handle of an id is fixed.
+template<class Heap>
+class NodeReplay{
+public:
+    typedef decltype(declval<Heap&>().insert(0)) Handle;
+    vector<Heap> heaps;
+    vector<Handle> handle_of;
+
+    NodeReplay(TraceHeader &header) : heaps(header.heaps), handle_of(header.ids){}
+    void insert(int heap, int id, int key);
+    int extract_min(int heap);
+    void decrease_key(int heap, int id, int key);
+    void delete_key(int heap, int id);
+    void merge(int heap, int from);
+};
+
+template<class Heap>
+void NodeReplay<Heap>::insert(int heap, int id, int key)
+{
+    handle_of[id] = heaps[heap].insert(key);
+}
+
+template<class Heap>
+int NodeReplay<Heap>::extract_min(int heap)
+{
+    return heaps[heap].extract_min();
+}
+
+template<class Heap>
+void NodeReplay<Heap>::decrease_key(int heap, int id, int key)
+{
+    heaps[heap].decrease_key(handle_of[id], key);
+}
+
+template<class Heap>
+void NodeReplay<Heap>::delete_key(int heap, int id)
+{
+    heaps[heap].delete_key(handle_of[id]);
+}
+
+//not every heap empties the other one, so it is reset here
+template<class Heap>
+void NodeReplay<Heap>::merge(int heap, int from)
+{
+    heaps[heap].merge(heaps[from]);
+    heaps[from] = Heap();
+}
+
+//FibonacciHeap and BinomialHeap delete by swapping the key up to the
+//root, so the keys of all the ancestors move one node down.
+template<class Heap>
+class DeleteSwapReplay : public NodeReplay<Heap>{
+protected:
+    typedef typename NodeReplay<Heap>::Handle Handle;
+    unordered_map<Handle, int> id_of;
+
+    void moveDown(Handle top, Handle parent);
+public:
+    DeleteSwapReplay(TraceHeader &header) : NodeReplay<Heap>(header){}
+    void insert(int heap, int id, int key);
+    void delete_key(int heap, int id);
+};
+
+//the id of the parent goes to the node below it
+template<class Heap>
+void DeleteSwapReplay<Heap>::moveDown(Handle top, Handle parent)
+{
+    int moved = id_of[parent];
+    id_of[top] = moved;
+    this->handle_of[moved] = top;
+}
+
+template<class Heap>
+void DeleteSwapReplay<Heap>::insert(int heap, int id, int key)
+{
+    NodeReplay<Heap>::insert(heap, id, key);
+    id_of[this->handle_of[id]] = id;
+}
+
+template<class Heap>
+void DeleteSwapReplay<Heap>::delete_key(int heap, int id)
+{
+    Handle current = this->handle_of[id];
+    for(Handle top=current; top->parent; top=top->parent){
+        moveDown(top, top->parent);
+    }
+
+    this->heaps[heap].delete_key(current);
+}
+
+//BinomialHeap also sifts a decreased key up by swapping
+template<class Heap>
+class SwapReplay : public DeleteSwapReplay<Heap>{
+    typedef typename DeleteSwapReplay<Heap>::Handle Handle;
+public:
+    SwapReplay(TraceHeader &header) : DeleteSwapReplay<Heap>(header){}
+    void decrease_key(int heap, int id, int key);
+};
+
+//the same walk as decrease_key
+template<class Heap>
+void SwapReplay<Heap>::decrease_key(int heap, int id, int key)
+{
+    Handle current = this->handle_of[id];
+    if(current->data <= key)
+        return;
+
+    Handle top = current;
+    while(top->parent && top->parent->data > key){
+        this->moveDown(top, top->parent);
+        top = top->parent;
+    }
+    this->id_of[top] = id;
+    this->handle_of[id] = top;
+
+    this->heaps[heap].decrease_key(current, key);
+}
+
+//The handles of IndexedBinaryHeap belong to one heap, a merge appends
+//the other heap and heapifies once, then the ids follow the moved map.
+class IndexedReplay{
+public:
+    vector<binary::IndexedBinaryHeap> heaps;
+    vector<int> handle_of;
+    vector<vector<int> > id_of;     //of each heap
+
+    IndexedReplay(TraceHeader &header) :
+        heaps(header.heaps), handle_of(header.ids), id_of(header.heaps){}
+    void insert(int heap, int id, int key);
+    int extract_min(int heap);
+    void decrease_key(int heap, int id, int key);
+    void delete_key(int heap, int id);
+    void merge(int heap, int from);
+};
+
+void IndexedReplay::insert(int heap, int id, int key)
+{
+    int handle = heaps[heap].insert(key);
+    if(handle >= (int)id_of[heap].size()){
+        id_of[heap].resize(handle+1);
+    }
+    id_of[heap][handle] = id;
+    handle_of[id] = handle;
+}
+
+int IndexedReplay::extract_min(int heap)
+{
+    return heaps[heap].extract_min();
+}
+
+void IndexedReplay::decrease_key(int heap, int id, int key)
+{
+    heaps[heap].decrease_key(handle_of[id], key);
+}
+
+void IndexedReplay::delete_key(int heap, int id)
+{
+    heaps[heap].delete_key(handle_of[id]);
+}
+
+void IndexedReplay::merge(int heap, int from)
+{
+    vector<int> moved;
+    heaps[heap].merge(heaps[from], moved);
+    for(int old=0; old<(int)moved.size(); old++){
+        int handle = moved[old];
+        if(handle < 0)
+            continue;
+
+        if(handle >= (int)id_of[heap].size()){
+            id_of[heap].resize(handle+1);
+        }
+        int id = id_of[from][old];
+        id_of[heap][handle] = id;
+        handle_of[id] = handle;
+    }
+}
+
+/*==============================================================*/
+//Function area
+//the bytes the program holds from malloc
+size_t heap_memory(void)
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+//Replay the records and return the sum of the extracted keys. An
+//extract_min on an empty heap is skipped and adds -1, like the heaps.
+//With latency set every operation is timed on its own, and the memory
+//is sampled every MEMORY_SAMPLE operations.
+template<class Replay>
+long long replay(Replay &queue, vector<TraceRecord> &records, int heaps,
+    StatsHistogram *latency, size_t &peak)
+{
+    vector<int> live(heaps, 0);
+    long long checksum = 0;
+    size_t base = heap_memory();
+    peak = 0;
+
+    for(int i=0; i<(int)records.size(); i++){
+        TraceRecord &r = records[i];
+        steady_clock::time_point start;
+        if(latency)
+            start = steady_clock::now();
+
+        switch(r.type){
+        case TRACE_OP_INSERT:
+            queue.insert(r.heap, r.id, r.key);
+            live[r.heap]++;
+            break;
+        case TRACE_OP_EXTRACT_MIN:
+            if(live[r.heap]){
+                checksum += queue.extract_min(r.heap);
+                live[r.heap]--;
+            }else{
+                checksum += -1;
+            }
+            break;
+        case TRACE_OP_DECREASE_KEY:
+            queue.decrease_key(r.heap, r.id, r.key);
+            break;
+        case TRACE_OP_DELETE:
+            queue.delete_key(r.heap, r.id);
+            live[r.heap]--;
+            break;
+        case TRACE_OP_MERGE:
+            queue.merge(r.heap, r.id);
+            live[r.heap] += live[r.id];
+            live[r.id] = 0;
+            break;
+        }
+
+        if(latency){
+            latency[r.type].record(duration_cast<nanoseconds>(
+                steady_clock::now() - start).count());
+            if(0 == i % MEMORY_SAMPLE){
+                size_t used = heap_memory();
+                if(used > base && used - base > peak)
+                    peak = used - base;
+            }
+        }
+    }
+
+    //drain, so the nodes are freed before the next heap
+    for(int h=0; h<heaps; h++){
+        while(live[h]--){
+            queue.extract_min(h);
+        }
+    }
+
+    return checksum;
+}
+
+//throughput from a plain replay, then the latency and memory from
+//a second replay with every operation timed
+template<class Replay>
+void run(const char *name, TraceHeader &header, vector<TraceRecord> &records)
+{
+    const char *op_names[TRACE_OPS] = {
+        "insert", "extract_min", "decrease_key", "delete", "merge"};
+    size_t peak;
+    long long checksum;
+
+    auto start = high_resolution_clock::now();
+    {
+        Replay queue(header);
+        checksum = replay(queue, records, header.heaps, NULL, peak);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+
+    StatsHistogram latency[TRACE_OPS];
+    {
+        Replay queue(header);
+        replay(queue, records, header.heaps, latency, peak);
+    }
+
+    cout << "Time taken by " << name << ": "
+         << duration.count() << " microseconds, "
+         << (double)records.size() / max((long long)duration.count(), 1LL)
+         << " Mops/s, peak memory :" << peak / 1024 << " KB"
+         << ", checksum :" << checksum << endl;
+    for(int i=0; i<TRACE_OPS; i++){
+        if(0 == latency[i].count)
+            continue;
+
+        cout << "    " << op_names[i] << " p50/p99/p999 :"
+             << latency[i].percentile(50) << "/"
+             << latency[i].percentile(99) << "/"
+             << latency[i].percentile(99.9) << " ns" << endl;
+    }
+}
+
+//Record a sample workload on a number of PairingHeaps through the
+//recorder, ops random operations over the heaps: inserts, decrease-keys and
+//deletes of random live keys, extract-mins and now and then a merge.
+//Keys are kept distinct so every heap extracts the same keys.
+bool record_sample(const char *path, int heaps, int ops)
+{
+    TraceWriter writer(path);
+    if(!writer.ok())
+        return false;
+
+    typedef TraceRecorder<pairing::PairingHeap> Recorder;
+    vector<Recorder*> queue;
+    vector<map<int, pairing::Node*> > keys(heaps);     //live key -> handle
+    vector<char> used(1<<24, 0);
+    queue.push_back(new Recorder(writer, 0));
+    for(int h=1; h<heaps; h++){
+        queue.push_back(new Recorder(writer, h, *queue[0]));
+    }
+
+    srand(2026);
+    for(int i=0; i<ops; i++){
+        int h = rand() % heaps;
+        int dice = rand() % 1000;
+        map<int, pairing::Node*> &live = keys[h];
+
+        //a random live key, the first one at or above a random key
+        auto it = live.lower_bound(rand() % (1<<24));
+        if(it == live.end() && !live.empty())
+            it = live.begin();
+
+        if(dice < 450 || live.empty()){
+            int key;
+            do{
+                key = rand() % (1<<24);
+            }while(used[key]);
+            used[key] = 1;
+            live[key] = queue[h]->insert(key);
+        }else if(dice < 750){
+            int key = it->first;
+            do{
+                key = key - 1 - rand() % 1024;
+            }while(key >= 0 && used[key]);
+            if(key < 0)
+                continue;
+
+            used[key] = 1;
+            live[key] = queue[h]->decrease_key(it->second, key);
+            live.erase(it);
+        }else if(dice < 950){
+            queue[h]->extract_min();
+            live.erase(live.begin());
+        }else if(dice < 999){
+            queue[h]->delete_key(it->second);
+            live.erase(it);
+        }else{
+            int from = rand() % heaps;
+            if(from == h)
+                continue;
+
+            queue[h]->merge(*queue[from]);
+            if(keys[from].size() > live.size()){
+                live.swap(keys[from]);
+            }
+            live.insert(keys[from].begin(), keys[from].end());
+            keys[from].clear();
+        }
+    }
+
+    for(int h=0; h<heaps; h++){
+        while(!keys[h].empty()){
+            queue[h]->extract_min();
+            keys[h].erase(keys[h].begin());
+        }
+    }
+
+    //the others share the id map of the first one
+    for(int h=0; h<heaps; h++){
+        delete queue[h];
+    }
+
+    return writer.close();
+}
+
+/*==============================================================*/
+int main(int argc, char const *argv[]){
+    // Load the trace, from the file in argv[1] or a sample one
+    // recorded to a temporary file
+    cout << "\n\tLoad the trace" << endl;
+    TraceHeader header;
+    vector<TraceRecord> records;
+    if(argc > 1){
+        if(!read_trace(argv[1], header, records)){
+            cout << "can not load " << argv[1] << endl;
+            return 1;
+        }
+    }else{
+        char path[] = "/tmp/heap_trace_XXXXXX";
+        int fd = mkstemp(path);
+        if(fd < 0){
+            cout << "can not create the temporary file" << endl;
+            return 1;
+        }
+        close(fd);
+
+        auto start = high_resolution_clock::now();
+        bool ok = record_sample(path, 8, BENCH_SCALE);
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<microseconds>(stop - start);
+        cout << "Time taken by recording: "
+             << duration.count() << " microseconds" << endl;
+
+        ok = ok && read_trace(path, header, records);
+        unlink(path);
+        if(!ok){
+            cout << "can not load " << path << endl;
+            return 1;
+        }
+    }
+    cout << "operations :" << header.ops << ", ids :" << header.ids
+         << ", heaps :" << header.heaps << endl;
+
+    // Replay on every heap
+    cout << "\n\tReplay" << endl;
+    run<IndexedReplay>("IndexedBinaryHeap", header, records);
+    run<NodeReplay<leftist::LeftistHeap> >("LeftistHeap", header, records);
+    run<NodeReplay<leftist::SkewHeap> >("SkewHeap", header, records);
+    run<SwapReplay<binomial::BinomialHeap> >("BinomialHeap", header, records);
+    run<DeleteSwapReplay<fibonacci::FibonacciHeap> >("FibonacciHeap", header, records);
+    run<NodeReplay<pairing::PairingHeap> >("PairingHeap", header, records);
+
+    return 0;
+}
+/*==============================================================*/